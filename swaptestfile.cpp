@@ -18,6 +18,13 @@
 
 #include "ATM_MathsFunctions/inc/ATM_MinorFunctions.h"
 
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <sstream>
+
 
 namespace {
 
@@ -48,12 +55,17 @@ const TokenType tkFixedCompoundingType(dont_initialize);
 
 const TokenType tkRateEndOfMonth(dont_initialize);
 
+const TokenType tkLogPayments(dont_initialize);
+
 const StringVector &getInterfaces()
 {
     static StringVector interfaces_s;
     if (interfaces_s.empty())
     {
         interfaces_s.push_back("MATURITY");
+        interfaces_s.push_back("SCHEDULECACHE");
+        interfaces_s.push_back("SCHEDULEPOOL");
+        interfaces_s.push_back("SCHEDULELADDER");
     }
     return interfaces_s;
 }
@@ -62,6 +74,8 @@ const StringVector interfaces_s = getInterfaces();
 const string empty_string_s;
 const string none_s("NONE");
 const string zero_bd_s("0BD");
+const string ladder_horizon_s("50Y");
+const double plan_tolerance_s = 1e-9;
 const string swap_str("SWAP");
 const string coupon_leg_str("COUPONLEG");
 const string coupon_legStart_str("COUPONLEGSTART");
@@ -126,6 +140,8 @@ InstrumentIRSwap::staticInit()
 
         tkRateEndOfMonth.init("RATE END OF MONTH");
 
+        tkLogPayments.init("LOG PAYMENTS");
+
         init = true;
     }
     return init;
@@ -219,11 +235,158 @@ struct FloatLegCheck : public LegCheck
     }
 };
 
+/// Identifies a generated schedule by everything that went into making it.
+/// The conventions string carries the calendar names, leg conventions, EOM
+/// flags and rate conventions; the dates carry roll dates and the start and
+/// end.  The calendars themselves are held too and compared by identity, so
+/// that schedules made before holiday data is reloaded are not matched by
+/// trades built after it; holding them keeps their addresses from being
+/// reused while the key is alive.
+struct SchedulePoolKey
+{
+    string conventions_m;
+    vector<Calendar_I::CPtr> calendars_m;
+    vector<Date> dates_m;
+    bool fudgeFirstFixing_m;
+
+    SchedulePoolKey() : fudgeFirstFixing_m(false) {}
+
+    bool operator<(const SchedulePoolKey& other) const
+    {
+        if (fudgeFirstFixing_m != other.fudgeFirstFixing_m)
+            return fudgeFirstFixing_m < other.fudgeFirstFixing_m;
+        if (conventions_m != other.conventions_m)
+            return conventions_m < other.conventions_m;
+        if (calendars_m.size() != other.calendars_m.size())
+            return calendars_m.size() < other.calendars_m.size();
+        for (size_t i = 0; i < calendars_m.size(); ++i)
+        {
+            const Calendar_I* mine = calendars_m[i].get();
+            const Calendar_I* theirs = other.calendars_m[i].get();
+            if (mine != theirs)
+                return std::less<const Calendar_I*>()(mine, theirs);
+        }
+        return dates_m < other.dates_m;
+    }
+};
+
+/// Builds the conventions part of a SchedulePoolKey.
+class ScheduleKeyWriter
+{
+public:
+    ScheduleKeyWriter& add(const string& value)
+    {
+        out_m << value << '|';
+        return *this;
+    }
+
+    ScheduleKeyWriter& add(const Tenor& value)
+    {
+        return add(value.toString());
+    }
+
+    ScheduleKeyWriter& add(int value)
+    {
+        out_m << value << '|';
+        return *this;
+    }
+
+    ScheduleKeyWriter& add(bool value)
+    {
+        out_m << (value ? 'T' : 'F') << '|';
+        return *this;
+    }
+
+    ScheduleKeyWriter& addCalendar(const Calendar_I::CPtr& calendar)
+    {
+        calendars_m.push_back(calendar);
+        return *this;
+    }
+
+    ScheduleKeyWriter& addCalendar(const string& name,
+                                   const string& conv,
+                                   const Calendar_I::CPtr& calendar)
+    {
+        return add(name).add(conv).addCalendar(calendar);
+    }
+
+    string str() const
+    {
+        return out_m.str();
+    }
+
+    // Sets the conventions and calendars of the key; its dates are left
+    // alone.
+    void write(SchedulePoolKey& key) const
+    {
+        key.conventions_m = str();
+        key.calendars_m.insert(key.calendars_m.end(), calendars_m.begin(), calendars_m.end());
+    }
+
+private:
+    std::ostringstream out_m;
+    vector<Calendar_I::CPtr> calendars_m;
+};
+
+/// A basis that is worked out once and then shared by every reader.  The
+/// first thread to finish publishes its basis with a single atomic
+/// compare-exchange; losers discard theirs and use the published one, so
+/// readers never take a lock.
+class PublishedBasis
+{
+public:
+    PublishedBasis() : basis_m(NULL) {}
+
+    PublishedBasis(const PublishedBasis& other) : basis_m(copy(other)) {}
+
+    PublishedBasis& operator=(const PublishedBasis& other)
+    {
+        if (this != &other)
+            delete basis_m.exchange(copy(other));
+        return *this;
+    }
+
+    ~PublishedBasis()
+    {
+        delete basis_m.load();
+    }
+
+    // Null until a basis has been published.
+    const Basis_I::CPtr* get() const
+    {
+        return basis_m.load(std::memory_order_acquire);
+    }
+
+    const Basis_I::CPtr& publish(const Basis_I::CPtr& basis) const
+    {
+        const Basis_I::CPtr* expected = NULL;
+        const Basis_I::CPtr* desired = new Basis_I::CPtr(basis);
+        if (!basis_m.compare_exchange_strong(expected, desired,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
+        {
+            delete desired;
+            return *expected;
+        }
+        return *desired;
+    }
+
+private:
+    static const Basis_I::CPtr* copy(const PublishedBasis& other)
+    {
+        const Basis_I::CPtr* basis = other.get();
+        return basis ? new Basis_I::CPtr(*basis) : NULL;
+    }
+
+    mutable std::atomic<const Basis_I::CPtr*> basis_m;
+};
+
 struct LegCal
 {
     Tenor freq_m;
     Tenor pay_lag_m;
     string acc_cal_name_m, acc_conv_name_m;
+    string pay_cal_name_m, pay_conv_name_m;
     Calendar_I::Ptr acc_cal_m;
     Calendar_I::Ptr pay_cal_m;
     bool front_stub_m, long_stub_m;
@@ -248,13 +411,13 @@ struct LegCal
         freq_m = result.getTenor(leg.tk_freq);
 
         acc_cal_name_m = result.getString(leg.tk_acc_cal, none_s);
-        const string pay_cal = result.getString(leg.tk_pay_cal, acc_cal_name_m);
+        pay_cal_name_m = result.getString(leg.tk_pay_cal, acc_cal_name_m);
 
         acc_conv_name_m = result.getString(leg.tk_acc_conv, none_s);
-        const string pay_conv = result.getString(leg.tk_pay_conv, acc_conv_name_m);
+        pay_conv_name_m = result.getString(leg.tk_pay_conv, acc_conv_name_m);
 
         acc_cal_m = result.getCalendar(acc_conv_name_m, acc_cal_name_m);
-        pay_cal_m = result.getCalendar(pay_conv, pay_cal);
+        pay_cal_m = result.getCalendar(pay_conv_name_m, pay_cal_name_m);
 
         pay_lag_m = result.getTenor(leg.tk_pay_lag, zero_bd_s);
 
@@ -262,27 +425,46 @@ struct LegCal
         long_stub_m = result.getBool(leg.tk_long_stub, true);
     }
 
+    void addToKey(ScheduleKeyWriter& key) const
+    {
+        key.add(freq_m).add(pay_lag_m)
+           .addCalendar(acc_cal_name_m, acc_conv_name_m, acc_cal_m)
+           .addCalendar(pay_cal_name_m, pay_conv_name_m, pay_cal_m)
+           .add(front_stub_m).add(long_stub_m)
+           .add(static_cast<int>(basisType_m));
+    }
+
+    // Safe to call concurrently; the first basis worked out is kept.
     const Basis_I::CPtr& getBasis(
         const vector<Date>* accrualDates,
         const Date* endDate,
         const bool* eom) const
     {
-        if (!basis_m) {
-            if (basisType_m == BasisUNKNOWN && defaults_m)
-                basis_m = defaults_m->getBasis(accrualDates, endDate, eom);
-            else {
-                basis_m = InstrumentBase::getBasis(
-                    basisType_m, acc_cal_m, accrualDates,
-                    &freq_m, endDate, eom);
-            }
-        }
+        if (const Basis_I::CPtr* basis = basis_m.get())
+            return *basis;
 
-        return basis_m;
+        if (basisType_m == BasisUNKNOWN && defaults_m)
+            return basis_m.publish(defaults_m->getBasis(accrualDates, endDate, eom));
+
+        return basis_m.publish(InstrumentBase::getBasis(
+            basisType_m, acc_cal_m, accrualDates,
+            &freq_m, endDate, eom));
+    }
+
+    // A copy with no basis worked out yet, taking any defaults from the
+    // given leg instead, so that the copy never fixes the basis of this
+    // leg or of its defaults.
+    LegCal detached(const LegCal* defaults) const
+    {
+        LegCal leg(*this);
+        leg.basis_m = PublishedBasis();
+        leg.defaults_m = defaults_m ? defaults : NULL;
+        return leg;
     }
 
 private:
-    mutable Basis_I::CPtr basis_m;
-    LegCal* defaults_m;
+    PublishedBasis basis_m;
+    const LegCal* defaults_m;
 };
 
 struct ConvSpec : public ConventionSpec
@@ -336,6 +518,666 @@ struct FloatRateConvSpec : public ConvSpec
     }
 };
 
+// ======================================================================
+// Schedule caching
+// ======================================================================
+
+/// A bounded, thread-safe cache of the schedules of a swap whose schedule
+/// floats with the now date.  Entries are keyed on the start and end dates
+/// the now date resolves to and the fudge_first_fixing flag, so now dates
+/// rolling onto the same spot date share a schedule.  The oldest entry is
+/// evicted once the cache is full.  Cached schedules are shared, so they
+/// must never be modified.
+class ScheduleCache
+{
+public:
+    explicit ScheduleCache(size_t capacity = 16) :
+        capacity_m(capacity), hits_m(0), misses_m(0)
+    {
+    }
+
+    // A copied instrument starts with an empty cache of its own.
+    ScheduleCache(const ScheduleCache& other) :
+        capacity_m(other.capacity_m), hits_m(0), misses_m(0)
+    {
+    }
+
+    ScheduleCache& operator=(const ScheduleCache& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            std::lock_guard<std::mutex> lock(mutex_m);
+            capacity_m = other.capacity_m;
+        }
+        return *this;
+    }
+
+    ScheduleInfo::Ptr find(const Date& start, const Date& end, bool fudgeFirstFixing) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        map<Key, ScheduleInfo::Ptr>::const_iterator it =
+            entries_m.find(Key(make_pair(start, end), fudgeFirstFixing));
+        if (it == entries_m.end())
+        {
+            ++misses_m;
+            return ScheduleInfo::Ptr();
+        }
+
+        ++hits_m;
+        return it->second;
+    }
+
+    // As find, without counting towards the hit and miss statistics.
+    bool contains(const Date& start, const Date& end, bool fudgeFirstFixing) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return entries_m.count(Key(make_pair(start, end), fudgeFirstFixing)) != 0;
+    }
+
+    // Returns the cached schedule, which is the one given unless another
+    // thread got there first.
+    ScheduleInfo::Ptr insert(const Date& start,
+                             const Date& end,
+                             bool fudgeFirstFixing,
+                             const ScheduleInfo::Ptr& schedule)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        const Key key(make_pair(start, end), fudgeFirstFixing);
+        map<Key, ScheduleInfo::Ptr>::const_iterator it = entries_m.find(key);
+        if (it != entries_m.end())
+            return it->second;
+
+        if (capacity_m == 0)
+            return schedule;
+
+        while (entries_m.size() >= capacity_m)
+        {
+            entries_m.erase(order_m.front());
+            order_m.pop_front();
+        }
+
+        entries_m[key] = schedule;
+        order_m.push_back(key);
+        return schedule;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        entries_m.clear();
+        order_m.clear();
+        hits_m = 0;
+        misses_m = 0;
+    }
+
+    size_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return hits_m;
+    }
+
+    size_t misses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return misses_m;
+    }
+
+private:
+    typedef pair<pair<Date, Date>, bool> Key;
+
+    mutable std::mutex mutex_m;
+    map<Key, ScheduleInfo::Ptr> entries_m;
+    deque<Key> order_m;
+    size_t capacity_m;
+    mutable size_t hits_m;
+    mutable size_t misses_m;
+};
+
+/// The fudge_first_fixing variant of a schedule frozen at validation.  It is
+/// made the first time it is asked for and then kept alongside the frozen
+/// schedule.
+class FudgedSchedule
+{
+public:
+    FudgedSchedule() {}
+
+    FudgedSchedule(const FudgedSchedule& other) : schedule_m(other.get()) {}
+
+    FudgedSchedule& operator=(const FudgedSchedule& other)
+    {
+        if (this != &other)
+        {
+            ScheduleInfo::Ptr schedule = other.get();
+            std::lock_guard<std::mutex> lock(mutex_m);
+            schedule_m = schedule;
+        }
+        return *this;
+    }
+
+    ScheduleInfo::Ptr get() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return schedule_m;
+    }
+
+    // Returns the kept schedule, which is the one given unless another
+    // thread got there first.
+    ScheduleInfo::Ptr set(const ScheduleInfo::Ptr& schedule)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        if (!schedule_m)
+            schedule_m = schedule;
+        return schedule_m;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        schedule_m = ScheduleInfo::Ptr();
+    }
+
+private:
+    mutable std::mutex mutex_m;
+    ScheduleInfo::Ptr schedule_m;
+};
+
+/// A bounded, thread-safe memo of calendar arithmetic keyed on the date it
+/// starts from.  Each use covers a single call site whose calendars and
+/// tenors are fixed for the life of the instrument, so the result depends
+/// on the date alone.  A copied instrument starts with an empty memo.
+template <class Value>
+class DateMemo
+{
+public:
+    explicit DateMemo(size_t capacity = 64) : capacity_m(capacity) {}
+
+    DateMemo(const DateMemo& other) : capacity_m(other.capacity_m) {}
+
+    DateMemo& operator=(const DateMemo& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            std::lock_guard<std::mutex> lock(mutex_m);
+            capacity_m = other.capacity_m;
+        }
+        return *this;
+    }
+
+    bool find(const Date& date, Value& value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        typename map<Date, Value>::const_iterator it = entries_m.find(date);
+        if (it == entries_m.end())
+            return false;
+        value = it->second;
+        return true;
+    }
+
+    void insert(const Date& date, const Value& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        if (capacity_m == 0 || entries_m.count(date))
+            return;
+
+        while (entries_m.size() >= capacity_m)
+        {
+            entries_m.erase(order_m.front());
+            order_m.pop_front();
+        }
+        entries_m[date] = value;
+        order_m.push_back(date);
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        entries_m.clear();
+        order_m.clear();
+    }
+
+private:
+    mutable std::mutex mutex_m;
+    map<Date, Value> entries_m;
+    deque<Date> order_m;
+    size_t capacity_m;
+};
+
+/// The boundary dates and shape of a schedule.  Computed once per schedule
+/// so that callers needing only the leg bounds do not regenerate or walk
+/// the periods.
+struct ScheduleSummary
+{
+    Date fixedStart_m, fixedEnd_m, fixedFirstPayment_m, fixedLastPayment_m;
+    Date floatStart_m, floatEnd_m, floatFirstPayment_m, floatLastPayment_m;
+    bool fixedFrontStub_m, fixedBackStub_m;
+    bool floatFrontStub_m, floatBackStub_m;
+    size_t fixedPeriods_m, floatPeriods_m;
+
+    explicit ScheduleSummary(const ScheduleInfo& schedule)
+    {
+        summarise(schedule.fixed_m.dates_m,
+                  fixedStart_m, fixedEnd_m, fixedFirstPayment_m, fixedLastPayment_m,
+                  fixedFrontStub_m, fixedBackStub_m, fixedPeriods_m);
+        summarise(schedule.float_m.dates_m,
+                  floatStart_m, floatEnd_m, floatFirstPayment_m, floatLastPayment_m,
+                  floatFrontStub_m, floatBackStub_m, floatPeriods_m);
+    }
+
+private:
+    // A single period is only ever treated as a front stub.
+    static void summarise(const vector<EventSchedule_I::IPeriod::CPtr>& periods,
+                          Date& start, Date& end,
+                          Date& firstPayment, Date& lastPayment,
+                          bool& frontStub, bool& backStub,
+                          size_t& count)
+    {
+        count = periods.size();
+        frontStub = false;
+        backStub = false;
+        if (periods.empty())
+            return;
+
+        start = periods.front()->getPeriodStartDate();
+        firstPayment = periods.front()->getPaymentDate();
+        end = periods.back()->getPeriodEndDate();
+        lastPayment = periods.back()->getPaymentDate();
+
+        frontStub = periods.front()->isStubPeriod();
+        backStub = count > 1 && periods.back()->isStubPeriod();
+    }
+};
+
+/// One leg of a schedule laid out as parallel arrays, one entry per period.
+/// The accrual year fractions are those of the leg basis and are left empty
+/// when the leg has none.
+struct CompactLeg
+{
+    vector<Date> start_m;
+    vector<Date> end_m;
+    vector<Date> fixing_m;
+    vector<Date> payment_m;
+    vector<char> stub_m;
+    vector<double> accrual_m;
+
+    void assign(const vector<EventSchedule_I::IPeriod::CPtr>& periods,
+                const Basis_I::CPtr& basis)
+    {
+        const size_t count = periods.size();
+        start_m.resize(count);
+        end_m.resize(count);
+        fixing_m.resize(count);
+        payment_m.resize(count);
+        stub_m.resize(count);
+        accrual_m.resize(basis ? count : 0);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const EventSchedule_I::IPeriod& period = *periods[i];
+            start_m[i] = period.getPeriodStartDate();
+            end_m[i] = period.getPeriodEndDate();
+            fixing_m[i] = period.getFixingDate();
+            payment_m[i] = period.getPaymentDate();
+            stub_m[i] = period.isStubPeriod();
+            if (basis)
+                accrual_m[i] = yearFraction(*basis, start_m[i], end_m[i]);
+        }
+    }
+
+    static double yearFraction(const Basis_I& basis, const Date& start, const Date& end)
+    {
+        return basis.getDCF(start, end);
+    }
+
+    size_t size() const { return start_m.size(); }
+    bool empty() const { return start_m.empty(); }
+
+    // A single period is only ever treated as a front stub.
+    bool hasFrontStub() const { return !empty() && stub_m.front(); }
+    bool hasBackStub() const { return size() > 1 && stub_m.back(); }
+
+    bool operator==(const CompactLeg& other) const
+    {
+        return start_m == other.start_m && end_m == other.end_m
+            && fixing_m == other.fixing_m && payment_m == other.payment_m
+            && stub_m == other.stub_m && accrual_m == other.accrual_m;
+    }
+};
+
+/// Both legs of a schedule in compact form.  The IPeriod vectors on
+/// ScheduleInfo remain the representation handed across the API; the
+/// pricing code reads this instead.
+struct CompactSchedule
+{
+    CompactLeg fixed_m;
+    CompactLeg float_m;
+
+    // Float accrual periods measured in the rate basis, i.e. the fraction a
+    // simple forward over the accrual period is quoted on.  Empty when the
+    // schedule has no rate basis.
+    vector<double> rateAccrual_m;
+
+    explicit CompactSchedule(const ScheduleInfo& schedule)
+    {
+        fixed_m.assign(schedule.fixed_m.dates_m, schedule.fixed_m.basis_m);
+        float_m.assign(schedule.float_m.dates_m, schedule.float_m.floatBasis_m);
+
+        if (const Basis_I::CPtr& rateBasis = schedule.float_m.rateBasis_m)
+        {
+            rateAccrual_m.resize(float_m.size());
+            for (size_t i = 0; i < float_m.size(); ++i)
+                rateAccrual_m[i] = CompactLeg::yearFraction(*rateBasis, float_m.start_m[i], float_m.end_m[i]);
+        }
+    }
+
+    // Same periods and accrual fractions on both legs.
+    bool operator==(const CompactSchedule& other) const
+    {
+        return fixed_m == other.fixed_m && float_m == other.float_m
+            && rateAccrual_m == other.rateAccrual_m;
+    }
+};
+
+/// Process-wide store of a view (summary or compact form) of each schedule,
+/// so that trades sharing a pooled schedule also share its views.  Keyed on
+/// the schedule itself; entries hold on to it, so a key cannot be reused
+/// while its entry exists.  Bounded like the schedule pool.
+template <class View>
+class ScheduleViewCache
+{
+public:
+    typedef Shared_ptr<const View> ViewPtr;
+
+    static ScheduleViewCache& instance()
+    {
+        static ScheduleViewCache cache;
+        return cache;
+    }
+
+    ViewPtr get(const ScheduleInfo::Ptr& schedule)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_m);
+            typename map<const ScheduleInfo*, Entry>::const_iterator it = entries_m.find(schedule.get());
+            if (it != entries_m.end())
+                return it->second.second;
+        }
+
+        // Built outside the lock; if another thread got there first, its
+        // view is kept.
+        ViewPtr view(new View(*schedule));
+
+        std::lock_guard<std::mutex> lock(mutex_m);
+        typename map<const ScheduleInfo*, Entry>::const_iterator it = entries_m.find(schedule.get());
+        if (it != entries_m.end())
+            return it->second.second;
+
+        if (order_m.size() >= capacity_m)
+        {
+            entries_m.erase(order_m.front());
+            order_m.pop_front();
+        }
+        entries_m[schedule.get()] = Entry(schedule, view);
+        order_m.push_back(schedule.get());
+        return view;
+    }
+
+private:
+    typedef pair<ScheduleInfo::Ptr, ViewPtr> Entry;
+
+    ScheduleViewCache() : capacity_m(65536) {}
+
+    mutable std::mutex mutex_m;
+    map<const ScheduleInfo*, Entry> entries_m;
+    deque<const ScheduleInfo*> order_m;
+    size_t capacity_m;
+};
+
+typedef ScheduleViewCache<ScheduleSummary> ScheduleSummaryCache;
+typedef ScheduleViewCache<CompactSchedule> CompactScheduleCache;
+
+/// Process-wide pool of immutable schedules.  Trades whose schedules are
+/// generated from identical inputs share a single ScheduleInfo.  The pool is
+/// bounded: the oldest entries are dropped first, and trades already holding
+/// them keep them.
+class SchedulePool
+{
+public:
+    static SchedulePool& instance()
+    {
+        static SchedulePool pool;
+        return pool;
+    }
+
+    ScheduleInfo::Ptr find(const SchedulePoolKey& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        map<SchedulePoolKey, ScheduleInfo::Ptr>::const_iterator it = entries_m.find(key);
+        return it == entries_m.end() ? ScheduleInfo::Ptr() : it->second;
+    }
+
+    // Returns the pooled schedule, which is the one given unless another
+    // thread got there first.
+    ScheduleInfo::Ptr insert(const SchedulePoolKey& key,
+                             const ScheduleInfo::Ptr& schedule)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        map<SchedulePoolKey, ScheduleInfo::Ptr>::const_iterator it = entries_m.find(key);
+        if (it != entries_m.end())
+            return it->second;
+
+        if (order_m.size() >= capacity_m)
+        {
+            entries_m.erase(order_m.front());
+            order_m.pop_front();
+        }
+        entries_m[key] = schedule;
+        order_m.push_back(key);
+        if (!key.fudgeFirstFixing_m)
+            ++schedules_m;
+        return schedule;
+    }
+
+    // Counts a trade that has taken its schedule from the pool.
+    void addTrade()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        ++trades_m;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return entries_m.size();
+    }
+
+    size_t trades() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return trades_m;
+    }
+
+    // Number of trades per schedule generated.
+    double dedupRatio() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return schedules_m == 0 ? 0.0 : double(trades_m)/schedules_m;
+    }
+
+private:
+    SchedulePool() : capacity_m(65536), trades_m(0), schedules_m(0) {}
+
+    mutable std::mutex mutex_m;
+    map<SchedulePoolKey, ScheduleInfo::Ptr> entries_m;
+    deque<SchedulePoolKey> order_m;
+    size_t capacity_m;
+    size_t trades_m;
+    size_t schedules_m;
+};
+
+/// Whether a trade has been counted in the schedule pool, so that a trade
+/// validated again is not counted again.
+class PooledTrade
+{
+public:
+    PooledTrade() : counted_m(false) {}
+
+    void count(SchedulePool& pool)
+    {
+        if (counted_m)
+            return;
+        pool.addTrade();
+        counted_m = true;
+    }
+
+private:
+    bool counted_m;
+};
+
+/// Process-wide store of master schedules for tenor ladders.  A master runs
+/// from a start date out to a long horizon for one convention set; shorter
+/// maturities on the same start take their periods as a prefix of it
+/// instead of generating their own.
+class ScheduleLadder
+{
+public:
+    /// A master schedule with the inputs needed to rebuild the bases of a
+    /// truncated copy.  Only masters without stubs or end-of-month rolling
+    /// are used, as only then does each regular boundary also end a
+    /// standalone schedule over the same periods.
+    struct Master
+    {
+        ScheduleInfo::Ptr schedule_m;
+        Date end_m;
+        vector<Date> fixedBaDates_m;
+        vector<Date> floatBaDates_m;
+        bool eom_m;
+
+        // Whether the first cut matched a standalone schedule: zero until
+        // that is known, then one if it did and minus one if it did not.
+        mutable std::atomic<int> checked_m;
+
+        Master() : eom_m(false), checked_m(0) {}
+
+        bool usable() const
+        {
+            return schedule_m && !eom_m
+                && regular(schedule_m->fixed_m.dates_m, fixedBaDates_m)
+                && regular(schedule_m->float_m.dates_m, floatBaDates_m);
+        }
+
+        // Number of leading periods ending on the given date, or zero if
+        // no period boundary falls on it.
+        static size_t periodsTo(const vector<Date>& baDates, const Date& end)
+        {
+            for (size_t i = 1; i < baDates.size(); ++i)
+            {
+                if (baDates[i] == end)
+                    return i;
+                if (end < baDates[i])
+                    break;
+            }
+            return 0;
+        }
+
+    private:
+        // Bond accrual dates line up one-to-one with the period boundaries.
+        static bool regular(const vector<EventSchedule_I::IPeriod::CPtr>& periods,
+                            const vector<Date>& baDates)
+        {
+            if (periods.empty() || baDates.size() != periods.size() + 1)
+                return false;
+            for (size_t i = 0; i < periods.size(); ++i)
+            {
+                if (periods[i]->isStubPeriod())
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    typedef Shared_ptr<const Master> MasterPtr;
+
+    static ScheduleLadder& instance()
+    {
+        static ScheduleLadder ladder;
+        return ladder;
+    }
+
+    // The master for the key if it reaches at least as far as the end date.
+    MasterPtr find(const SchedulePoolKey& key, const Date& end) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        map<SchedulePoolKey, MasterPtr>::const_iterator it = entries_m.find(key);
+        if (it == entries_m.end() || it->second->end_m < end)
+            return MasterPtr();
+        return it->second;
+    }
+
+    // Counts a schedule actually cut from a master.
+    void addPrefix()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        ++prefixes_m;
+    }
+
+    // Keeps the longer of the given master and any already held.
+    MasterPtr insert(const SchedulePoolKey& key, const MasterPtr& master)
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        ++builds_m;
+        map<SchedulePoolKey, MasterPtr>::iterator it = entries_m.find(key);
+        if (it != entries_m.end())
+        {
+            if (master->end_m < it->second->end_m)
+                return it->second;
+            it->second = master;
+            return master;
+        }
+
+        if (order_m.size() >= capacity_m)
+        {
+            entries_m.erase(order_m.front());
+            order_m.pop_front();
+        }
+        entries_m[key] = master;
+        order_m.push_back(key);
+        return master;
+    }
+
+    size_t builds() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return builds_m;
+    }
+
+    size_t prefixes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        return prefixes_m;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_m);
+        entries_m.clear();
+        order_m.clear();
+        builds_m = 0;
+        prefixes_m = 0;
+    }
+
+private:
+    ScheduleLadder() : capacity_m(64), builds_m(0), prefixes_m(0) {}
+
+    mutable std::mutex mutex_m;
+    map<SchedulePoolKey, MasterPtr> entries_m;
+    deque<SchedulePoolKey> order_m;
+    size_t capacity_m;
+    size_t builds_m;
+    size_t prefixes_m;
+};
+
 // ======================================================================
 // Swap objects
 // ======================================================================
@@ -361,29 +1203,47 @@ public:
             addOptional(tkCurveInterval, ParseString);
 
             addOptional(tkFloatIndexCurve, ParseID);
+
+            addOptional(tkLogPayments, ParseBool);
         }
 
         ConvSpec conv_spec_m;
     };
 
+    // Summary of the (unfudged) schedule for the given now date.
+    ScheduleSummaryCache::ViewPtr getScheduleSummary(const Date& nowDate) const
+    {
+        return getScheduleSummary(calc_schedule(nowDate, false));
+    }
+
+    ScheduleSummaryCache::ViewPtr getScheduleSummary(const ScheduleInfo::Ptr& schedule) const
+    {
+        return ScheduleSummaryCache::instance().get(schedule);
+    }
+
+    CompactScheduleCache::ViewPtr getCompactSchedule(const ScheduleInfo::Ptr& schedule) const
+    {
+        return CompactScheduleCache::instance().get(schedule);
+    }
+
     Date getFixedEndDate(const Date& nowDate) const
     {
-        return calc_schedule(nowDate, false)->fixed_m.dates_m.back()->getPeriodEndDate();
+        return getScheduleSummary(nowDate)->fixedEnd_m;
     }
 
     Date getFloatEndDate(const Date& nowDate) const
     {
-        return calc_schedule(nowDate, false)->float_m.dates_m.back()->getPeriodEndDate();
+        return getScheduleSummary(nowDate)->floatEnd_m;
     }
 
     Date getFixedStartDate(const Date& nowDate) const
     {
-        return calc_schedule(nowDate, false)->fixed_m.dates_m.front()->getPeriodStartDate();
+        return getScheduleSummary(nowDate)->fixedStart_m;
     }
 
     Date getFloatStartDate(const Date& nowDate) const
     {
-        return calc_schedule(nowDate, false)->float_m.dates_m.front()->getPeriodStartDate();
+        return getScheduleSummary(nowDate)->floatStart_m;
     }
 
     virtual void getStartAndEndDatesForFixedFloatSwap(
@@ -391,14 +1251,16 @@ public:
         Date& start,
         Date& end) const
     {
-        Date fixedStart = getFixedStartDate(nowDate);
-        Date floatStart = getFloatStartDate(nowDate);
+        ScheduleSummaryCache::ViewPtr summary = getScheduleSummary(nowDate);
+
+        const Date& fixedStart = summary->fixedStart_m;
+        const Date& floatStart = summary->floatStart_m;
         start = (fixedStart < floatStart) ? fixedStart : floatStart;
         if (start < nowDate)
             start = nowDate;
 
-        Date fixedEnd = getFixedEndDate(nowDate);
-        Date floatEnd = getFloatEndDate(nowDate);
+        const Date& fixedEnd = summary->fixedEnd_m;
+        const Date& floatEnd = summary->floatEnd_m;
         end = (fixedEnd > floatEnd) ? fixedEnd : floatEnd;
         if (end < nowDate)
             end = nowDate;
@@ -502,6 +1364,10 @@ public:
         priority_m = result.getDouble(tkCurvePriority, 1);
         interval_m = result.getTenor(tkCurveInterval, zero_bd_s);
 
+        // Payments are logged unless the trade opts out, so that runs
+        // which never log can skip the log work per path.
+        logPayments_m = result.getBool(tkLogPayments, true);
+
         floatIndexCurveBinder_m = MarketBinder(tkFloatIndexCurve,result);
 
         return true;
@@ -515,30 +1381,29 @@ public:
 
     void viewWithSchedule(ApplicationData& out, const ScheduleInfo::Ptr &schedule) const
     {
-        const FixedScheduleInfo& fixed = schedule->fixed_m;
-        for(size_t i = 0; i < fixed.dates_m.size(); i++)
+        CompactScheduleCache::ViewPtr compact = getCompactSchedule(schedule);
+
+        const CompactLeg& fixed = compact->fixed_m;
+        for(size_t i = 0; i < fixed.size(); i++)
         {
-            const EventSchedule_I::IPeriod::CPtr& period = fixed.dates_m[i];
-            out.appendData(tkEventsAccrualStart, period->getPeriodStartDate());
-            out.appendData(tkEventsAccrualEnd, period->getPeriodEndDate());
-            out.appendData(tkEventsPaymentDate, period->getPaymentDate());
+            out.appendData(tkEventsAccrualStart, fixed.start_m[i]);
+            out.appendData(tkEventsAccrualEnd, fixed.end_m[i]);
+            out.appendData(tkEventsPaymentDate, fixed.payment_m[i]);
         }
 
         if(hasTwoLegs_m)
         {
-            const FloatScheduleInfo& floating = schedule->float_m;
+            const CompactLeg& floating = compact->float_m;
 
-            if(!floating.dates_m.size())
+            if(floating.empty())
                 return;
 
-            for(size_t i = 0; i < floating.dates_m.size(); ++i)
+            for(size_t i = 0; i < floating.size(); ++i)
             {
-                const EventSchedule_I::IPeriod::CPtr& period = floating.dates_m[i];
-
-                out.appendData(tkEventsFloatLegFixDate, period->getFixingDate());
-                out.appendData(tkEventsFloatLegAccrualStart, period->getPeriodStartDate());
-                out.appendData(tkEventsFloatLegAccrualEnd, period->getPeriodEndDate());
-                out.appendData(tkEventsFloatLegPayDate, period->getPaymentDate());
+                out.appendData(tkEventsFloatLegFixDate, floating.fixing_m[i]);
+                out.appendData(tkEventsFloatLegAccrualStart, floating.start_m[i]);
+                out.appendData(tkEventsFloatLegAccrualEnd, floating.end_m[i]);
+                out.appendData(tkEventsFloatLegPayDate, floating.payment_m[i]);
             }
         }
     }
@@ -567,6 +1432,175 @@ public:
         virtual const string& description() const = 0;
     };
 
+    /// The cash flows of a vanilla single-currency swap laid out flat, so that
+    /// a stripping product can value the legs straight off discount factors.
+    /// Amounts already carry the leg notionals from stripNotionals, signs
+    /// included, and the accrual fractions.
+    struct SwapCashflowPlan
+    {
+        Date nowDate_m;
+
+        vector<Date> fixedPayment_m;
+        vector<double> fixedAmount_m;
+
+        vector<Date> floatPayment_m;
+        vector<Date> rateStart_m;
+        vector<Date> rateEnd_m;
+        vector<double> forwardAmount_m;
+        vector<double> spreadAmount_m;
+
+        /// Discount factors off a curve as seen from the now date.
+        struct CurveDF
+        {
+            CurveDF(const YieldCurve_I& curve, const Date& nowDate) :
+                curve_m(curve), nowDate_m(nowDate) {}
+
+            double operator()(const Date& date) const
+            {
+                return curve_m.getDF(nowDate_m, date);
+            }
+
+            const YieldCurve_I& curve_m;
+            const Date& nowDate_m;
+        };
+
+        template <class DF>
+        double fixedValue(const DF& fixDisc) const
+        {
+            double value = 0.0;
+            for (size_t i = 0; i < fixedPayment_m.size(); ++i)
+                value += fixedAmount_m[i] * fixDisc(fixedPayment_m[i]);
+            return value;
+        }
+
+        // The forward over each rate period is implied from the projection
+        // discount factors at its ends.
+        template <class DF>
+        double floatValue(const DF& floatDisc, const DF& floatProj) const
+        {
+            double value = 0.0;
+            for (size_t i = 0; i < floatPayment_m.size(); ++i)
+            {
+                const double growth = floatProj(rateStart_m[i]) / floatProj(rateEnd_m[i]);
+                value += floatDisc(floatPayment_m[i])
+                    * (forwardAmount_m[i] * (growth - 1.0) + spreadAmount_m[i]);
+            }
+            return value;
+        }
+    };
+
+    /// A cashflow plan together with what has been learnt by checking it
+    /// against the full price.  The plan values the swap as the instrument
+    /// does, the floating leg less the fixed leg, so nothing is fitted: it is
+    /// trusted once it has matched the full price at enough distinct curve
+    /// states, and retired for good on any mismatch.
+    class CheckedCashflowPlan
+    {
+    public:
+        explicit CheckedCashflowPlan(const Shared_ptr<const SwapCashflowPlan>& plan) :
+            plan_m(plan),
+            checks_m(0),
+            lastFixedValue_m(0.0),
+            lastFloatValue_m(0.0)
+        {
+        }
+
+        bool trusted() const
+        {
+            return plan_m && checks_m.load(std::memory_order_acquire) >= checksNeeded_s;
+        }
+
+        // Whether full prices should still be compared with the plan.
+        bool checking() const
+        {
+            return plan_m && checks_m.load(std::memory_order_acquire) >= 0;
+        }
+
+        const SwapCashflowPlan& plan() const { return *plan_m; }
+
+
+        void legValues(const Date& nowDate,
+                       const YieldCurve_I& fix,
+                       const YieldCurve_I& floatDisc,
+                       const YieldCurve_I& floatProj,
+                       double fixedScale,
+                       double floatScale,
+                       double& fixedValue,
+                       double& floatValue) const
+        {
+            fixedValue = fixedScale * plan_m->fixedValue(SwapCashflowPlan::CurveDF(fix, nowDate));
+            floatValue = floatScale * plan_m->floatValue(SwapCashflowPlan::CurveDF(floatDisc, nowDate),
+                                                         SwapCashflowPlan::CurveDF(floatProj, nowDate));
+        }
+
+        double value(const Date& nowDate,
+                     const YieldCurve_I& fix,
+                     const YieldCurve_I& floatDisc,
+                     const YieldCurve_I& floatProj,
+                     double fixedScale,
+                     double floatScale) const
+        {
+            double fixedValue, floatValue;
+            legValues(nowDate, fix, floatDisc, floatProj, fixedScale, floatScale, fixedValue, floatValue);
+            return swapValue(fixedValue, floatValue);
+        }
+
+        // As in the swap payoff, the fixed leg is paid and the floating leg
+        // received; the leg notionals carry the rest of the sign.
+        static double swapValue(double fixedValue, double floatValue)
+        {
+            return floatValue - fixedValue;
+        }
+
+        // Compares the plan with the full price.  A match only counts when
+        // the curves have moved the legs since the last one counted, so that
+        // the same curve state priced twice confirms nothing new.
+        void check(double price,
+                   const Date& nowDate,
+                   const YieldCurve_I& fix,
+                   const YieldCurve_I& floatDisc,
+                   const YieldCurve_I& floatProj,
+                   double fixedScale,
+                   double floatScale) const
+        {
+            double fixedValue, floatValue;
+            legValues(nowDate, fix, floatDisc, floatProj, fixedScale, floatScale, fixedValue, floatValue);
+            const double tolerance = plan_tolerance_s * (1.0 + std::fabs(fixedValue) + std::fabs(floatValue));
+
+            std::lock_guard<std::mutex> lock(mutex_m);
+            const int checks = checks_m.load(std::memory_order_relaxed);
+            if (checks < 0 || checks >= checksNeeded_s)
+                return;
+
+            if (std::fabs(swapValue(fixedValue, floatValue) - price) > tolerance)
+            {
+                checks_m.store(-1, std::memory_order_release);
+                return;
+            }
+
+            if (checks > 0 &&
+                std::fabs(fixedValue - lastFixedValue_m) <= tolerance &&
+                std::fabs(floatValue - lastFloatValue_m) <= tolerance)
+                return;
+
+            lastFixedValue_m = fixedValue;
+            lastFloatValue_m = floatValue;
+            checks_m.store(checks + 1, std::memory_order_release);
+        }
+
+    private:
+        static const int checksNeeded_s = 2;
+
+        Shared_ptr<const SwapCashflowPlan> plan_m;
+        mutable std::atomic<int> checks_m;
+        mutable std::mutex mutex_m;
+        mutable double lastFixedValue_m;
+        mutable double lastFloatValue_m;
+
+        CheckedCashflowPlan(const CheckedCashflowPlan&);
+        CheckedCashflowPlan& operator=(const CheckedCashflowPlan&);
+    };
+
     class SwapDualYieldCurveInstrument : public DualYieldCurveInstrument {
     public:
 
@@ -577,8 +1611,9 @@ public:
             const Date& start,
             const Date& end,
             double priority,
-            const Tenor& interval)
-            : DualYieldCurveInstrument(id, name, nowDate, start, end, priority, interval), swapInst_m(swapInst) {}
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan)
+            : DualYieldCurveInstrument(id, name, nowDate, start, end, priority, interval), swapInst_m(swapInst), plan_m(plan) {}
 
         virtual ~SwapDualYieldCurveInstrument() {}
 
@@ -587,25 +1622,41 @@ public:
             const YieldCurve_I::CPtr &discountingCurve,
             const YieldCurve_I::CPtr &indexCurve) const 
         {
-            vector<FIN_PaymentStream::OutFlow> flowsOut;
-            vector<FIN_PaymentStream::OutFlow> fixsOut;
-            vector<FIN_PaymentStream::OutFlow> floatsOut;
+            if (plan_m.trusted())
+                return plan_m.value(getNowDate(), *discountingCurve, *discountingCurve, *indexCurve, 1.0, 1.0);
+
+            // No flows are asked for, so the shared empty buffers stay empty.
             Shared_ptr<FIN_SwapInstrument::PriceResults> prices = 
                 swapInst_m->price(getNowDate(), getNowDate(), 1.0, 
-                discountingCurve, indexCurve, 1.0, discountingCurve, indexCurve, false, false, flowsOut, fixsOut, floatsOut);
-            string msg;
-            return prices->getPrice(&msg);
+                discountingCurve, indexCurve, 1.0, discountingCurve, indexCurve, false, false, noFlows_s, noFlows_s, noFlows_s);
 
+            const double price = prices->getPrice(NULL);
+            if (plan_m.checking())
+                plan_m.check(price, getNowDate(), *discountingCurve, *discountingCurve, *indexCurve, 1.0, 1.0);
+            return price;
         }
 
     private:
 
         FIN_SwapInstrument::CPtr swapInst_m;
+        CheckedCashflowPlan plan_m;
 
         SwapDualYieldCurveInstrument(const SwapDualYieldCurveInstrument &);
         SwapDualYieldCurveInstrument &operator=(const SwapDualYieldCurveInstrument &);
     };
 
+    // The cash flows of the stripping swap laid out flat; null keeps the
+    // products on the full pricer.
+    virtual Shared_ptr<const SwapCashflowPlan> makeCashflowPlan(const Date& nowDate,
+                                                                const IQuotes::CPtr& quotes,
+                                                                const BumpShift* bump,
+                                                                int& bumpUsedOut,
+                                                                const Currency& curveCurrency,
+                                                                bool fudgeFirstFixing) const
+    {
+        return Shared_ptr<const SwapCashflowPlan>();
+    }
+
     // Gets a Dual Yield Curve Product for this instrument.
     virtual DualYieldCurveInstrument::CPtr getDualYieldCurveProduct(
         const Date& nowDate,
@@ -619,7 +1670,13 @@ public:
         FIN_SwapInstrument::CPtr swapInst = this->instrument(nowDate, quotes, 
             bump.asInstanceOf<const BumpShift>().get(), true, CurveTenorInterpolated::Ptr(), 
             bumpUsedOut, warning, startOut, endOut, false);
-        return DualYieldCurveInstrument::CPtr(new SwapDualYieldCurveInstrument(swapInst, getID().toString(), "", nowDate, swapInst->start(), swapInst->end(), priority_m, interval_m));
+
+        Shared_ptr<const SwapCashflowPlan> plan;
+        if (!warning.isFatal())
+            plan = makeCashflowPlan(nowDate, quotes, bump.asInstanceOf<const BumpShift>().get(),
+                                    bumpUsedOut, getCurrency(), false);
+
+        return DualYieldCurveInstrument::CPtr(new SwapDualYieldCurveInstrument(swapInst, getID().toString(), "", nowDate, swapInst->start(), swapInst->end(), priority_m, interval_m, plan));
     }
 
     /// A yield curve product where some of the yield curves are held constant
@@ -641,9 +1698,11 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) :
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) :
         YCProductInstrument(id.toString(), nowDate, swap->description(), rate, start, end, priority, interval),
         swap_m(swap),
+        plan_m(plan),
         spotDate_m(spotDate),
         fixedIsReporting_m(fixedIsReporting),
         fixedScale_m(fixedScale),
@@ -669,6 +1728,9 @@ public:
                     fixedScale *= floatDisc->getDF(getNowDate(), spotDate_m)/fix->getDF(getNowDate(), spotDate_m);
             }
 
+            if (plan_m.trusted())
+                return plan_m.value(getNowDate(), *fix, *floatDisc, *floatProj, fixedScale, floatScale);
+
             Shared_ptr<FIN_SwapInstrument::PriceResults> swapPrices =
                 swap_m->price(getNowDate(),
                               getNowDate(),
@@ -684,7 +1746,10 @@ public:
                               false,
                               noFlows_s, noFlows_s, noFlows_s);
 
-            return swapPrices->getPrice(NULL);
+            const double price = swapPrices->getPrice(NULL);
+            if (plan_m.checking())
+                plan_m.check(price, getNowDate(), *fix, *floatDisc, *floatProj, fixedScale, floatScale);
+            return price;
         }
 
         virtual void getCurves(
@@ -696,6 +1761,7 @@ public:
 
     private:
         Shared_ptr<const Priceable> swap_m;
+        CheckedCashflowPlan plan_m;
         Date spotDate_m;
         bool fixedIsReporting_m;
         double fixedScale_m;
@@ -717,7 +1783,8 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) const = 0;
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) const = 0;
     };
 
     struct SinglePriceable : public Priceable
@@ -846,12 +1913,13 @@ public:
                 double floatScale,
                 double priority,
                 const Tenor& interval,
+                const Shared_ptr<const SwapCashflowPlan>& plan,
                 YieldCurve_I::CPtr floatDisc,
                 YieldCurve_I::CPtr floatProj) :
             CurriedSwapProduct(
                 id.toString(), nowDate, spotDate, swap, rate,
                 start, end, true, fixedScale, floatScale,
-                priority, interval),
+                priority, interval, plan),
             floatDisc_m(floatDisc), floatProj_m(floatProj)
             {
             }
@@ -884,11 +1952,12 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) const
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) const
         {
             return new Product(
                 id, nowDate, spotDate, swap, rate, start, end,
-                fixedScale, floatScale, priority, interval, floatDisc_m, floatProj_m);
+                fixedScale, floatScale, priority, interval, plan, floatDisc_m, floatProj_m);
         }
 
     private:
@@ -926,12 +1995,13 @@ public:
                 double floatScale,
                 double priority,
                 const Tenor& interval,
+                const Shared_ptr<const SwapCashflowPlan>& plan,
                 const YieldCurve_I::CPtr& fixDisc,
                 const YieldCurve_I::CPtr& floatProj) :
             CurriedSwapProduct(
                 id.toString(), nowDate, spotDate, swap, rate,
                 start, end, false, fixedScale, floatScale,
-                priority, interval),
+                priority, interval, plan),
             fixDisc_m(fixDisc), floatProj_m(floatProj)
             {
             }
@@ -964,11 +2034,12 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) const
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) const
         {
             return new Product(
                 id, nowDate, spotDate, swap, rate, start, end,
-                fixedScale, floatScale, priority, interval, fixDisc_m, floatProj_m);
+                fixedScale, floatScale, priority, interval, plan, fixDisc_m, floatProj_m);
         }
 
     private:
@@ -998,11 +2069,12 @@ public:
                 double fixedScale,
                 double floatScale,
                 double priority,
-                const Tenor& interval) :
+                const Tenor& interval,
+                const Shared_ptr<const SwapCashflowPlan>& plan) :
             CurriedSwapProduct(
                 id.toString(), nowDate, spotDate, swap, rate,
                 start, end, true, fixedScale, floatScale,
-                priority, interval)
+                priority, interval, plan)
             {
             }
 
@@ -1030,11 +2102,12 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) const
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) const
         {
             return new Product(
                 id, nowDate, spotDate, swap, rate, start, end,
-                fixedScale, floatScale, priority, interval);
+                fixedScale, floatScale, priority, interval, plan);
         }
     };
 
@@ -1070,12 +2143,13 @@ public:
                 double floatScale,
                 double priority,
                 const Tenor& interval,
+                const Shared_ptr<const SwapCashflowPlan>& plan,
                 const YieldCurve_I::CPtr& fixDisc,
                 const YieldCurve_I::CPtr& floatDisc) :
             CurriedSwapProduct(
                 id.toString(), nowDate, spotDate, swap, rate,
                 start, end, fixedIsReporting, fixedScale, floatScale,
-                priority, interval),
+                priority, interval, plan),
             fixDisc_m(fixDisc), floatDisc_m(floatDisc)
             {
             }
@@ -1108,11 +2182,12 @@ public:
             double fixedScale,
             double floatScale,
             double priority,
-            const Tenor& interval) const
+            const Tenor& interval,
+            const Shared_ptr<const SwapCashflowPlan>& plan) const
         {
             return new Product(
                 id, nowDate, spotDate, swap, rate, start, end, fixedIsReporting_m,
-                fixedScale, floatScale, priority, interval, fixDisc_m, floatDisc_m);
+                fixedScale, floatScale, priority, interval, plan, fixDisc_m, floatDisc_m);
         }
 
     private:
@@ -1216,16 +2291,18 @@ public:
                 events->addCashflow(fund_date_str, sched->float_m.dates_m);
         }
 
-        events->addCashflow(coupon_legStart_str, sched->fixed_m.dates_m.front()->getPeriodStartDate());
-        events->addCashflow(coupon_legEnd_str, sched->fixed_m.dates_m.back()->getPaymentDate());
+        ScheduleSummaryCache::ViewPtr summary = getScheduleSummary(sched);
 
-        events->addCashflow(fund_legStart_str, sched->float_m.dates_m.front()->getPeriodStartDate());
-        events->addCashflow(fund_legEnd_str, sched->float_m.dates_m.back()->getPaymentDate());
+        events->addCashflow(coupon_legStart_str, summary->fixedStart_m);
+        events->addCashflow(coupon_legEnd_str, summary->fixedLastPayment_m);
 
-        if(sched->float_m.dates_m.front()->isStubPeriod())
+        events->addCashflow(fund_legStart_str, summary->floatStart_m);
+        events->addCashflow(fund_legEnd_str, summary->floatLastPayment_m);
+
+        if(summary->floatFrontStub_m)
             events->addCashflow(fund_front_stub_date_str, sched->float_m.dates_m.front());
 
-        if(sched->float_m.dates_m.size() != 1 && sched->float_m.dates_m.back()->isStubPeriod())
+        if(summary->floatBackStub_m)
             events->addCashflow(fund_back_stub_date_str, sched->float_m.dates_m.back());
 
         return events.release();
@@ -1244,10 +2321,13 @@ public:
 
         pn.arrayNames_m.clear();
 
-        pn.logNames_m.push_back(coupon_log_str);
+        if(logPayments_m)
+        {
+            pn.logNames_m.push_back(coupon_log_str);
 
-        if(hasTwoLegs_m)
-            pn.logNames_m.push_back(fund_log_str);
+            if(hasTwoLegs_m)
+                pn.logNames_m.push_back(fund_log_str);
+        }
     }
 
     virtual void getArrayValues(const string& name,
@@ -1285,19 +2365,31 @@ protected:
     class SwapPayoff : public Payoff_I
     {
     public:
-        SwapPayoff(const CurrencyType fixedCurrType,
-                   const CurrencyType floatCurrType,
-                   bool doFrontStubInterpolation,
-                   bool doBackStubInterpolation,
-                   const pair<double,double>& frontStubRateWeights,
-                   const pair<double,double>& backStubRateWeights) :
-        isCrossCurrency_m(fixedCurrType != floatCurrType),
-        fixedCurrType_m(fixedCurrType),
-        floatCurrType_m(floatCurrType),
-        doFrontStubInterpolation_m(doFrontStubInterpolation),
-        doBackStubInterpolation_m(doBackStubInterpolation),
-        frontStubRateWeights_m(frontStubRateWeights),
-        backStubRateWeights_m(backStubRateWeights)
+        /// What the payoff needs to know about the legs, shared by every
+        /// variant.
+        struct Shape
+        {
+            CurrencyType fixedCurrType_m;
+            CurrencyType floatCurrType_m;
+            bool doFrontStubInterpolation_m;
+            bool doBackStubInterpolation_m;
+            pair<double,double> frontStubRateWeights_m;
+            pair<double,double> backStubRateWeights_m;
+
+            bool logPayments_m;
+
+            bool isCrossCurrency() const { return fixedCurrType_m != floatCurrType_m; }
+            bool hasStubs() const { return doFrontStubInterpolation_m || doBackStubInterpolation_m; }
+        };
+
+        explicit SwapPayoff(const Shape& shape) :
+        fixedCurrType_m(shape.fixedCurrType_m),
+        floatCurrType_m(shape.floatCurrType_m),
+        doFrontStubInterpolation_m(shape.doFrontStubInterpolation_m),
+        doBackStubInterpolation_m(shape.doBackStubInterpolation_m),
+        frontStubRateWeights_m(shape.frontStubRateWeights_m),
+        backStubRateWeights_m(shape.backStubRateWeights_m),
+        logPayments_m(shape.logPayments_m)
         {}
 
         virtual const PricingDirectionType getPricingDirection() const
@@ -1306,41 +2398,86 @@ protected:
         }
 
     protected:
+        Shape shape() const
+        {
+            Shape shape;
+            shape.fixedCurrType_m = fixedCurrType_m;
+            shape.floatCurrType_m = floatCurrType_m;
+            shape.doFrontStubInterpolation_m = doFrontStubInterpolation_m;
+            shape.doBackStubInterpolation_m = doBackStubInterpolation_m;
+            shape.frontStubRateWeights_m = frontStubRateWeights_m;
+            shape.backStubRateWeights_m = backStubRateWeights_m;
+            shape.logPayments_m = logPayments_m;
+            return shape;
+        }
+
+        // Whether payments are logged is settled when the payoff is
+        // registered, so a payoff that does not log does no log work per
+        // path.
+        void logCashflow(const Underlying& amount,
+                         const string& dateString,
+                         const string& logString,
+                         CurrencyType currType)
+        {
+            if(logPayments_m)
+                logPayment(amount, dateString, EffectiveDateThisPay, logString, currType);
+        }
+
+        // The leg helpers take the shape of the swap as template arguments,
+        // so that each payoff variant is compiled without the branches it
+        // cannot take.
+        template <bool CrossCurrency>
         void doFixedLeg(const Underlying& notional,
                         Underlying& fixedLeg)
         {
             const Underlying dcf = get(coupon_dcf_str);
             const Underlying fixedRate = get(fixed_str);
-            const Underlying coupon = dcf * fixedRate * notional * (isCrossCurrency_m ? -1.0 : 1.0);
-            logPayment(coupon, coupon_date_str, EffectiveDateThisPay, coupon_log_str, fixedCurrType_m);
+            const Underlying coupon = CrossCurrency ? -(dcf * fixedRate * notional) : dcf * fixedRate * notional;
+            logCashflow(coupon, coupon_date_str, coupon_log_str, fixedCurrType_m);
+            fixedLeg += cash(coupon, coupon_date_str, EffectiveDateThisPay, fixedCurrType_m);
+        }
+
+        // As doFixedLeg, for a notional known when the payoff is built: the
+        // cross currency sign is folded into it then, leaving two products
+        // per coupon.
+        void doScaledFixedLeg(double signedNotional,
+                              Underlying& fixedLeg)
+        {
+            const Underlying coupon = get(coupon_dcf_str) * get(fixed_str) * signedNotional;
+            logCashflow(coupon, coupon_date_str, coupon_log_str, fixedCurrType_m);
             fixedLeg += cash(coupon, coupon_date_str,EffectiveDateThisPay, fixedCurrType_m);
         }
 
+        template <bool CrossCurrency>
         void doFixedLeg(Underlying& fixedLeg)
         {
             const Underlying fixedCashflow = get(fixed_cashflow_str);
-            const Underlying coupon = fixedCashflow * (isCrossCurrency_m ? -1.0 : 1.0);
-            logPayment(coupon, coupon_date_str, EffectiveDateThisPay, coupon_log_str, fixedCurrType_m);
+            const Underlying coupon = CrossCurrency ? -fixedCashflow : fixedCashflow;
+            logCashflow(coupon, coupon_date_str, coupon_log_str, fixedCurrType_m);
             fixedLeg += cash(coupon, coupon_date_str,EffectiveDateThisPay, fixedCurrType_m);
         }
 
+        // The notional is a plain double for payoffs that know it when they
+        // are built, so that no Underlying is made of it per coupon.
+        template <class Notional>
         void addFloatLegCoupon(const Underlying& liborRate,
                                const Underlying& spread,
                                const Underlying& dcf,
-                               const Underlying& notional,
+                               const Notional& notional,
                                const string& dateString,
                                const string& logString,
                                Underlying& floatLeg)
         {
             Underlying coupon = (liborRate + spread) * dcf * notional;
-            logPayment(coupon, dateString, EffectiveDateThisPay, logString, floatCurrType_m);
+            logCashflow(coupon, dateString, logString, floatCurrType_m);
             floatLeg += cash(coupon, dateString, EffectiveDateThisPay, floatCurrType_m);
         }
 
-        void doFloatLeg(const Underlying& notional,
+        template <bool Stubs, class Notional>
+        void doFloatLeg(const Notional& notional,
                         Underlying& floatLeg)
         {
-            if(doFrontStubInterpolation_m && isActive(fund_front_stub_date_str))
+            if(Stubs && doFrontStubInterpolation_m && isActive(fund_front_stub_date_str))
             {
                 Underlying liborRate = frontStubRateWeights_m.first*get(libor_front_short_stub_str);
                 if(frontStubRateWeights_m.second != 0.0)
@@ -1354,7 +2491,7 @@ protected:
                                   fund_log_str,
                                   floatLeg);
             }            
-            else if(doBackStubInterpolation_m && isActive(fund_back_stub_date_str))
+            else if(Stubs && doBackStubInterpolation_m && isActive(fund_back_stub_date_str))
             {
                 Underlying liborRate = backStubRateWeights_m.first*get(libor_back_short_stub_str);
                 if(backStubRateWeights_m.second != 0.0)
@@ -1389,32 +2526,33 @@ protected:
         {
             if(initialNotionalExchange && isActive(coupon_legStart_str))
             {
-                logPayment(fixedNotional, coupon_legStart_str, EffectiveDateThisPay, coupon_log_str, fixedCurrType_m);
+                logCashflow(fixedNotional, coupon_legStart_str, coupon_log_str, fixedCurrType_m);
                 fixedLeg += cash(fixedNotional, coupon_legStart_str, EffectiveDateThisPay, fixedCurrType_m);
             }
             if(finalNotionalExchange && isActive(coupon_legEnd_str))
             {
-                logPayment(-fixedNotional, coupon_legEnd_str, EffectiveDateThisPay, coupon_log_str, fixedCurrType_m);
+                logCashflow(-fixedNotional, coupon_legEnd_str, coupon_log_str, fixedCurrType_m);
                 fixedLeg += cash(-fixedNotional,  coupon_legEnd_str,EffectiveDateThisPay, fixedCurrType_m);
             }
             if(initialNotionalExchange && isActive(fund_legStart_str))
             {
-                logPayment(-floatNotional, fund_legStart_str, EffectiveDateThisPay, fund_log_str, floatCurrType_m);
+                logCashflow(-floatNotional, fund_legStart_str, fund_log_str, floatCurrType_m);
                 floatLeg += cash(-floatNotional, fund_legStart_str, EffectiveDateThisPay, floatCurrType_m);
             }
             if(finalNotionalExchange && isActive(fund_legEnd_str))
             {
-                logPayment(floatNotional, fund_legEnd_str, EffectiveDateThisPay, fund_log_str, floatCurrType_m);
+                logCashflow(floatNotional, fund_legEnd_str, fund_log_str, floatCurrType_m);
                 floatLeg += cash(floatNotional, fund_legEnd_str, EffectiveDateThisPay, floatCurrType_m);
             }
         }
 
+        template <bool CrossCurrency>
         void getSwap(const Underlying& fixedLeg,
                      const Underlying& floatLeg,
                      Underlying& swap)
         {
             // fixed leg is negated for cross currency swaps.
-            swap = isCrossCurrency_m ? floatLeg + fixedLeg : floatLeg - fixedLeg;
+            swap = CrossCurrency ? floatLeg + fixedLeg : floatLeg - fixedLeg;
         }
 
     protected:
@@ -1425,10 +2563,29 @@ protected:
         bool doBackStubInterpolation_m;
         pair<double,double> frontStubRateWeights_m;
         pair<double,double> backStubRateWeights_m;
-
-        bool isCrossCurrency_m;
+        bool logPayments_m;
     };
 
+    // Registers the variant of a payoff family fixed by three flags, each
+    // variant built from the family's terms.
+    template <template <bool, bool, bool> class Payoff, class Terms>
+    static void registerPayoffVariant(const NXKernel_I::Ptr& kernel,
+                                      bool first, bool second, bool third,
+                                      const Terms& terms)
+    {
+        switch((first ? 4 : 0) + (second ? 2 : 0) + (third ? 1 : 0))
+        {
+        case 0: { Payoff<false, false, false> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 1: { Payoff<false, false, true> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 2: { Payoff<false, true, false> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 3: { Payoff<false, true, true> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 4: { Payoff<true, false, false> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 5: { Payoff<true, false, true> payoff(terms); kernel->registerPayoff(payoff); break; }
+        case 6: { Payoff<true, true, false> payoff(terms); kernel->registerPayoff(payoff); break; }
+        default: { Payoff<true, true, true> payoff(terms); kernel->registerPayoff(payoff); break; }
+        }
+    }
+
     virtual ScheduleInfo::Ptr calc_schedule(const Date& now_date,
                                             bool fudge_first_fixing) const
     {
@@ -1454,11 +2611,7 @@ protected:
         if (!schedule || !floatStubIndexCurve)
             return false;
 
-        const vector<EventSchedule_I::IPeriod::CPtr>& floatDates = schedule->float_m.dates_m;
-        if( floatDates.front()->isStubPeriod() && floatStubIndexCurve )
-            return true;
-
-        return false;
+        return getCompactSchedule(schedule)->float_m.hasFrontStub();
     }
 
     bool doBackStubInterpolation(const ScheduleInfo::Ptr& schedule,
@@ -1467,11 +2620,7 @@ protected:
         if (!schedule || !floatStubIndexCurve)
             return false;
 
-        const vector<EventSchedule_I::IPeriod::CPtr>& floatDates = schedule->float_m.dates_m;
-        if( (floatDates.size() > 1) && floatDates.back()->isStubPeriod() && floatStubIndexCurve )
-            return true;
-
-        return false;
+        return getCompactSchedule(schedule)->float_m.hasBackStub();
     }
 
     void setStubWeightsAndRateEndDates(const ScheduleInfo::Ptr& schedule,
@@ -1483,12 +2632,12 @@ protected:
     {
         Date stubStartDate;
         Date stubEndDate;
-        const vector<EventSchedule_I::IPeriod::CPtr>& floatDates = schedule->float_m.dates_m;
+        const CompactLeg& floatLeg = getCompactSchedule(schedule)->float_m;
 
-        if(floatStubIndexCurve && floatDates.front()->isStubPeriod())
+        if(floatStubIndexCurve && floatLeg.hasFrontStub())
         {
-            stubStartDate = floatDates.front()->getPeriodStartDate();
-            stubEndDate = floatDates.front()->getPeriodEndDate();
+            stubStartDate = floatLeg.start_m.front();
+            stubEndDate = floatLeg.end_m.front();
 
             Calendar_I::CPtr cal = schedule->float_m.acc_cal_m;
             Basis_I::CPtr rateBasis = schedule->float_m.rateBasis_m;
@@ -1500,10 +2649,10 @@ protected:
                                                                frontStubRateWeights);
         }
 
-        if(floatDates.size() != 1 && floatDates.back()->isStubPeriod())
+        if(floatLeg.hasBackStub())
         {
-            stubStartDate = floatDates.back()->getPeriodStartDate();
-            stubEndDate = floatDates.back()->getPeriodEndDate();
+            stubStartDate = floatLeg.start_m.back();
+            stubEndDate = floatLeg.end_m.back();
 
             Calendar_I::CPtr cal = schedule->float_m.acc_cal_m;
             Basis_I::CPtr rateBasis = schedule->float_m.rateBasis_m;
@@ -1675,6 +2824,39 @@ protected:
 
     }
 
+    // The (unfudged) schedule the kernel events are built from, if the model
+    // knows its now date.
+    ScheduleInfo::Ptr registrationSchedule(Model_I::PtrCRef model) const
+    {
+        if(model->isNowDateSet())   // TODO: This is used elsewhere, but is a problem as many models don't support this
+            return calc_schedule(model->nowDate(), false);
+        return ScheduleInfo::Ptr();
+    }
+
+    // Hands the kernel the accrual fractions already held with the schedule,
+    // keyed on the period fixing dates as for other per-period data.  Without
+    // a schedule the kernel derives them from the basis itself.
+    void registerAccrualFractions(const NXKernel_I::Ptr& kernel,
+                                  const ScheduleInfo::Ptr& schedule,
+                                  bool fixedLeg,
+                                  const string& dcfName,
+                                  const string& dateName,
+                                  BasisType basisType) const
+    {
+        if(schedule)
+        {
+            CompactScheduleCache::ViewPtr compact = getCompactSchedule(schedule);
+            const CompactLeg& leg = fixedLeg ? compact->fixed_m : compact->float_m;
+            if(!leg.empty() && leg.accrual_m.size() == leg.size())
+            {
+                kernel->registerData(dcfName, leg.fixing_m, leg.accrual_m, InterpolationFlatLHS);
+                return;
+            }
+        }
+
+        kernel->registerDCF(dcfName, dateName, basisType);
+    }
+
     void doRegistrationTwoLegs(const NXKernel_I::Ptr& kernel,
                                Model_I::PtrCRef model,
                                const Bump* bump,
@@ -1698,8 +2880,9 @@ protected:
                            fixedCurrencyType,
                            floatCurrencyType);
 
-        kernel->registerDCF(coupon_dcf_str, coupon_date_str, fixedBasisType);
-        kernel->registerDCF(fund_date_dcf_str, fund_date_str, floatBasisType);
+        ScheduleInfo::Ptr schedule = registrationSchedule(model);
+        registerAccrualFractions(kernel, schedule, true, coupon_dcf_str, coupon_date_str, fixedBasisType);
+        registerAccrualFractions(kernel, schedule, false, fund_date_dcf_str, fund_date_str, floatBasisType);
 
         YieldCurve_I::Ptr floatIndexCurve;
         if (CurveYieldBase::Ptr fp = getFloatIndexCurve())
@@ -1748,21 +2931,16 @@ protected:
             pair<double, double> stubWeights;
             pair<Date, Date> stubRateEndDates;
 
-    		ScheduleInfo::Ptr schedule;
-            if(model->isNowDateSet())   // TODO: This is used elsewhere, but is a problem as many models don't support this
-            {
-                schedule = calc_schedule(model->nowDate(), false);
-            }
-
             if (schedule)
             {
                 Date frontStubStartDate;
                 Date frontStubEndDate;
+                const CompactLeg& floatLeg = getCompactSchedule(schedule)->float_m;
 
-                if (schedule->float_m.dates_m.front()->isStubPeriod())
+                if (floatLeg.hasFrontStub())
                 {
-                    frontStubStartDate = schedule->float_m.dates_m.front()->getPeriodStartDate();
-                    frontStubEndDate = schedule->float_m.dates_m.front()->getPeriodEndDate();
+                    frontStubStartDate = floatLeg.start_m.front();
+                    frontStubEndDate = floatLeg.end_m.front();
 
                     registerStubIndex(frontStubStartDate,
                                       frontStubEndDate,
@@ -1781,10 +2959,10 @@ protected:
                                       rateFixingCalendar);
                 }
                 
-                if (schedule->float_m.dates_m.size() > 1 && schedule->float_m.dates_m.back()->isStubPeriod())
+                if (floatLeg.hasBackStub())
                 {
-                    Date backStubStartDate = schedule->float_m.dates_m.back()->getPeriodStartDate();
-                    Date backStubEndDate = schedule->float_m.dates_m.back()->getPeriodEndDate();
+                    Date backStubStartDate = floatLeg.start_m.back();
+                    Date backStubEndDate = floatLeg.end_m.back();
 
                     registerStubIndex(backStubStartDate,
                                       backStubEndDate,
@@ -1826,6 +3004,7 @@ protected:
     double priority_m;
     Tenor interval_m;
     size_t compounding_frequency_m;
+    bool logPayments_m;
 };
 
 class ConstantParameterSwap : public Swap
@@ -1899,6 +3078,14 @@ public:
         return 0;
     }
 
+    // Called before a stripping product is built, so that a subclass can
+    // make the schedule calc_schedule will hand the product more cheaply
+    // than it would on its own.
+    virtual void prepareStripSchedule(const Date& nowDate,
+                                      bool fudgeFirstFixing) const
+    {
+    }
+
     // Uses a product factory to create a stripping product.  Various
     // specific methods below instantiate a factory and then call
     // this method.
@@ -1918,11 +3105,14 @@ public:
         if(priority_m == 999)
             return YCProductInstrument::Ptr();
 
+        prepareStripSchedule(nowDate, fudgeFirstFixing);
+
         Date start, end;
 
         const BumpShift* bumpShift = dynamic_cast<const BumpShift*>(bump.get());
 
         Shared_ptr<const Priceable> priceable;
+        Shared_ptr<const SwapCashflowPlan> plan;
         if(isCC) {
             CrossCurrencyBasisSwapInstrument::CPtr inst = ccInstrument(
                 nowDate,
@@ -1953,18 +3143,124 @@ public:
                 end,
                 fudgeFirstFixing);
             priceable = new SinglePriceable(inst);
+
+            if(!warning.isFatal())
+                plan = makeCashflowPlan(nowDate, quotes, bumpShift, bumpUsedOut,
+                                        curveCurrency, fudgeFirstFixing);
+        }
+
+        if(warning.isFatal())
+            return YCProductInstrument::Ptr();
+
+        return YCProductInstrument::Ptr(factory.get(getID().toString(),
+                                                    nowDate, spotDate,
+                                                    priceable,
+                                                    fixedRate_m->getValue(quotes, bumpShift, bumpUsedOut),
+                                                    start, end,
+                                                    fixedScale, floatScale,
+                                                    priority_m, interval_m,
+                                                    plan));
+    }
+
+    // Whether the floating rate is set over the rate period implied by each
+    // fixing date rather than over the accrual period.
+    virtual bool usesRateDates() const
+    {
+        return true;
+    }
+
+    // Whether rate periods roll to month end.  The plan rolls rate dates by
+    // plain tenor, so a swap that says yes stays on the full pricer.
+    virtual bool rateEndOfMonth() const
+    {
+        return false;
+    }
+
+    // Lays out the cash flows of the swap that instrument() builds for
+    // stripping, or returns null if that swap is not vanilla enough to be
+    // valued straight off the curves: compounding, fixings already set,
+    // interpolated float stubs, end-of-month rate periods and a missing
+    // basis all keep it on the full pricer.
+    virtual Shared_ptr<const SwapCashflowPlan> makeCashflowPlan(const Date& nowDate,
+                                                        const IQuotes::CPtr& quotes,
+                                                        const BumpShift* bump,
+                                                        int& bumpUsedOut,
+                                                        const Currency& curveCurrency,
+                                                        bool fudgeFirstFixing) const
+    {
+        const Shared_ptr<const SwapCashflowPlan> none;
+        if(!hasTwoLegs_m || compounding_frequency_m != 0)
+            return none;
+
+        ScheduleInfo::Ptr schedule = calc_schedule(nowDate, fudgeFirstFixing);
+        if(!schedule)
+            return none;
+
+        if(doFrontStubInterpolation(schedule, floatStubIndexCurve_m) ||
+           doBackStubInterpolation(schedule, floatStubIndexCurve_m))
+            return none;
+
+        const FloatScheduleInfo& floatInfo = schedule->float_m;
+        CompactScheduleCache::ViewPtr compact = getCompactSchedule(schedule);
+        const CompactLeg& fixed = compact->fixed_m;
+        const CompactLeg& floating = compact->float_m;
+        if(fixed.accrual_m.size() != fixed.size() ||
+           floating.accrual_m.size() != floating.size() ||
+           compact->rateAccrual_m.size() != floating.size())
+            return none;
+
+        const bool rateDates = usesRateDates();
+        if(rateDates && (!floatInfo.fixing_cal_m || !floatInfo.acc_cal_m || rateEndOfMonth()))
+            return none;
+
+        double fixedNotional, floatNotional;
+        stripNotionals(true, curveCurrency, fixedNotional, floatNotional);
+        const double fixedRate = fixedRate_m->getValue(quotes, bump, bumpUsedOut);
+        const double spread = floatRate_m->getValue(quotes, bump, bumpUsedOut);
+        const bool fixingsSet = queryFixingsFunc().get() != NULL;
+
+        Shared_ptr<SwapCashflowPlan> plan(new SwapCashflowPlan);
+        plan->nowDate_m = nowDate;
+
+        for(size_t i = 0; i < fixed.size(); ++i)
+        {
+            if(fixed.payment_m[i] < nowDate)
+                continue;
+            plan->fixedPayment_m.push_back(fixed.payment_m[i]);
+            plan->fixedAmount_m.push_back(fixedNotional * fixedRate * fixed.accrual_m[i]);
         }
 
-        if(warning.isFatal())
-            return YCProductInstrument::Ptr();
+        for(size_t i = 0; i < floating.size(); ++i)
+        {
+            if(floating.payment_m[i] < nowDate)
+                continue;
 
-        return YCProductInstrument::Ptr(factory.get(getID().toString(),
-                                                    nowDate, spotDate,
-                                                    priceable,
-                                                    fixedRate_m->getValue(quotes, bumpShift, bumpUsedOut),
-                                                    start, end,
-                                                    fixedScale, floatScale,
-                                                    priority_m, interval_m));
+            const Date& fixing = floating.fixing_m[i];
+            if(fixing < nowDate || (fixing == nowDate && fixingsSet && !fudgeFirstFixing))
+                return none;
+
+            Date rateStart = floating.start_m[i];
+            Date rateEnd = floating.end_m[i];
+            double rateAccrual = compact->rateAccrual_m[i];
+            if(rateDates)
+            {
+                rateStart = fixing;
+                floatInfo.fixing_cal_m->addTenor(rateStart, floatInfo.fix_lag_m);
+                rateEnd = rateStart;
+                floatInfo.acc_cal_m->addTenor(rateEnd, floatInfo.freq_m);
+                rateAccrual = CompactLeg::yearFraction(*floatInfo.rateBasis_m, rateStart, rateEnd);
+            }
+            if(rateAccrual == 0.0)
+                return none;
+
+            plan->floatPayment_m.push_back(floating.payment_m[i]);
+            plan->rateStart_m.push_back(rateStart);
+            plan->rateEnd_m.push_back(rateEnd);
+            plan->forwardAmount_m.push_back(floatNotional * floating.accrual_m[i] / rateAccrual);
+            plan->spreadAmount_m.push_back(floatNotional * spread * floating.accrual_m[i]);
+        }
+
+        return plan;
     }
 
     virtual YCProductInstrument::Ptr getDiscYCProduct(const Currency& domCurrency,
@@ -2128,18 +3424,8 @@ public:
                                                Date& end_out,
                                                bool fudge_first_fixing) const
     {
-        double fixedNotional = unitNotional ? -1.0 : fixedNotional_m;
-        double floatNotional = unitNotional ? -1.0 : floatNotional_m;
-
-        if(unitNotional && fixedNotional_m != floatNotional_m)
-        {
-            if(curveCurrency == getFixedCurrency())
-                floatNotional = -floatNotional_m/fixedNotional_m;
-            else if(curveCurrency == getFloatCurrency())
-                fixedNotional = -fixedNotional_m/floatNotional_m;
-            else
-                throwFatalException("Domestic currency not known by the swap.");
-        }
+        double fixedNotional, floatNotional;
+        stripNotionals(unitNotional, curveCurrency, fixedNotional, floatNotional);
 
         ScheduleInfo::Ptr schedule = calc_schedule(now_date, fudge_first_fixing);
 
@@ -2173,6 +3459,27 @@ protected:
         return true;
     }
 
+    // The leg notionals instrument() builds with.  Unit notionals scale the
+    // leg not in the curve currency by the notional ratio.
+    void stripNotionals(bool unitNotional,
+                        const Currency& curveCurrency,
+                        double& fixedNotional,
+                        double& floatNotional) const
+    {
+        fixedNotional = unitNotional ? -1.0 : fixedNotional_m;
+        floatNotional = unitNotional ? -1.0 : floatNotional_m;
+
+        if(unitNotional && fixedNotional_m != floatNotional_m)
+        {
+            if(curveCurrency == getFixedCurrency())
+                floatNotional = -floatNotional_m/fixedNotional_m;
+            else if(curveCurrency == getFloatCurrency())
+                fixedNotional = -fixedNotional_m/floatNotional_m;
+            else
+                throwFatalException("Domestic currency not known by the swap.");
+        }
+    }
+
     void parseSingleCcyNotional(const ParseResult& result)
     {
         fixedNotional_m = result.getDouble(tkStructureNotional, 1.0);
@@ -2196,27 +3503,22 @@ protected:
         floatRate_m = floatRate;
     }
 
+    struct ConstantParameterPayoffTerms
+    {
+        double fixedNotional_m;
+        double floatNotional_m;
+        Swap::SwapPayoff::Shape shape_m;
+    };
+
+    template <bool TwoLegs, bool CrossCurrency, bool Stubs>
     class ConstantParameterSwapPayoff : public Swap::SwapPayoff
     {
     public:
-        ConstantParameterSwapPayoff(bool hasTwoLegs,
-                                    double fixedNotional,
-                                    const CurrencyType fixedCurrType,
-                                    double floatNotional,
-                                    const CurrencyType floatCurrType,
-                                    bool doFrontStubInterpolation,
-                                    bool doBackStubInterpolation,
-                                    const pair<double,double>& frontStubRateWeights,
-                                    const pair<double,double>& backStubRateWeights) :
-        SwapPayoff(fixedCurrType,
-                   floatCurrType,
-                   doFrontStubInterpolation,
-                   doBackStubInterpolation,
-                   frontStubRateWeights,
-                   backStubRateWeights),
-        hasTwoLegs_m(hasTwoLegs),
-        fixedNotional_m(fixedNotional),
-        floatNotional_m(floatNotional)
+        explicit ConstantParameterSwapPayoff(const ConstantParameterPayoffTerms& terms) :
+        SwapPayoff(terms.shape_m),
+        fixedNotional_m(terms.fixedNotional_m),
+        floatNotional_m(terms.floatNotional_m),
+        signedFixedNotional_m(CrossCurrency ? -terms.fixedNotional_m : terms.fixedNotional_m)
         {}
 
         virtual void doPayoff()
@@ -2224,17 +3526,17 @@ protected:
             Underlying fixed_leg = get(coupon_leg_str);
 
             if(isActive(coupon_date_str))
-                doFixedLeg(fixedNotional_m,
-                           fixed_leg);
+                doScaledFixedLeg(signedFixedNotional_m,
+                                 fixed_leg);
 
-            if(hasTwoLegs_m) {
+            if(TwoLegs) {
                 Underlying float_leg = get(fund_leg_str);
 
                 if(isActive(fund_date_str))
-                    doFloatLeg(floatNotional_m,
-                               float_leg);
+                    doFloatLeg<Stubs>(floatNotional_m,
+                                      float_leg);
 
-                if(isCrossCurrency_m)
+                if(CrossCurrency)
                     doNotionalExchange(fixedNotional_m,
                                        floatNotional_m,
                                        true, true,
@@ -2242,28 +3544,25 @@ protected:
                                        float_leg);
 
                 Underlying swap = get(swap_str);
-                getSwap(fixed_leg, float_leg,
-                        swap);
+                getSwap<CrossCurrency>(fixed_leg, float_leg,
+                                       swap);
             }
         }
 
         virtual Cloneable_I* clone() const
         {
-            return new ConstantParameterSwapPayoff(hasTwoLegs_m,
-                                                   fixedNotional_m,
-                                                   fixedCurrType_m,
-                                                   floatNotional_m,
-                                                   floatCurrType_m,
-                                                   doFrontStubInterpolation_m,
-                                                   doBackStubInterpolation_m,
-                                                   frontStubRateWeights_m,
-                                                   backStubRateWeights_m);
+            ConstantParameterPayoffTerms terms;
+            terms.fixedNotional_m = fixedNotional_m;
+            terms.floatNotional_m = floatNotional_m;
+            terms.shape_m = shape();
+
+            return new ConstantParameterSwapPayoff(terms);
         }
 
     private:
-        bool hasTwoLegs_m;
         double fixedNotional_m;
         double floatNotional_m;
+        double signedFixedNotional_m;
     };
 
     virtual void registerData(const NXKernel_I::Ptr& kernel,
@@ -2283,17 +3582,22 @@ protected:
                                 const pair<double,double>& frontStubRateWeights,
                                 const pair<double,double>& backStubRateWeights)
     {
-        ConstantParameterSwapPayoff payoff(hasTwoLegs_m,
-                                           fixedNotional_m,
-                                           fixedCurrencyType,
-                                           floatNotional_m,
-                                           floatCurrencyType,
-                                           doFrontStubInterpolation,
-                                           doBackStubInterpolation,
-                                           frontStubRateWeights,
-                                           backStubRateWeights);
+        ConstantParameterPayoffTerms terms;
+        terms.fixedNotional_m = fixedNotional_m;
+        terms.floatNotional_m = floatNotional_m;
+        terms.shape_m.fixedCurrType_m = fixedCurrencyType;
+        terms.shape_m.floatCurrType_m = floatCurrencyType;
+        terms.shape_m.doFrontStubInterpolation_m = doFrontStubInterpolation;
+        terms.shape_m.doBackStubInterpolation_m = doBackStubInterpolation;
+        terms.shape_m.frontStubRateWeights_m = frontStubRateWeights;
+        terms.shape_m.backStubRateWeights_m = backStubRateWeights;
+        terms.shape_m.logPayments_m = logPayments_m;
 
-        kernel->registerPayoff(payoff);
+        registerPayoffVariant<ConstantParameterSwapPayoff>(kernel,
+                                                           hasTwoLegs_m,
+                                                           terms.shape_m.isCrossCurrency(),
+                                                           terms.shape_m.hasStubs(),
+                                                           terms);
     }
 
 protected:
@@ -2355,6 +3659,11 @@ public:
         }
     };
 
+    virtual bool usesRateDates() const
+    {
+        return useRateDates_m;
+    }
+
 protected:
     virtual bool validate()
     {
@@ -2513,6 +3822,10 @@ protected:
         if(!NewSwap::validate())
             return false;
 
+        schedule_cache_m.clear();
+        fudged_schedule_m.clear();
+        resolved_dates_m.clear();
+
         const ParseResult& result = getParameters();
 
         refDate_m = result.queryDate(tkEventsRefDate);
@@ -2533,8 +3846,13 @@ protected:
             floatFixingLag_m.toString(), "F",
             floatFixingCalendarName, float_leg_m.acc_cal_name_m);
 
+        const string maturity_conv("NONE");
+        const string maturity_cal("NONE");
         maturity_m = result.getMaturity(
-            tkMaturityDate, "NONE", "NONE", floatEndOfMonth_m);
+            tkMaturityDate, maturity_conv, maturity_cal, floatEndOfMonth_m);
+
+        // Ladder masters roll out to their horizon the way the maturity does.
+        maturityCal_m = result.getCalendar(maturity_conv, maturity_cal);
 
         const string float_fix_conv = result.getString(tkFloatFixingConvention, "P");
         floatFixingCal_m = result.getCalendar(float_fix_conv, floatFixingCalendarName);
@@ -2562,49 +3880,265 @@ protected:
 
         rateBasisType_m = result.getBasis(tkRateBasis, float_leg_m.basisType_m);
 
+        ScheduleKeyWriter key;
+        key.addCalendar(nominal_cal_m);
+        fixed_leg_m.addToKey(key);
+        key.add(fixedEndOfMonth_m);
+        float_leg_m.addToKey(key);
+        key.add(floatEndOfMonth_m)
+           .addCalendar(floatFixingCalendarName, float_fix_conv, floatFixingCal_m)
+           .add(floatFixingLag_m);
+        key.add(static_cast<int>(rateBasisType_m))
+           .add(useRateDates_m)
+           .addCalendar(acc_cal, acc_conv, rateAccrualCal_m)
+           .add(rateFrequency_m)
+           .addCalendar(fix_cal, rate_fix_conv, rateFixingCal_m)
+           .add(rateSpotLag_m)
+           .add(rateEndOfMonth_m);
+        schedule_key_m = SchedulePoolKey();
+        key.write(schedule_key_m);
+
         return true;
     }
 
+    // Makes the schedule for the given now date through the global schedule
+    // pool, so that trades with identical schedule inputs share one
+    // ScheduleInfo.  Use for schedules that are frozen at validation.
+    ScheduleInfo::Ptr pooled_schedule(const Date& now_date,
+                                      bool fudge_first_fixing) const
+    {
+        Date start, end;
+        resolve_dates(now_date, start, end);
+
+        SchedulePoolKey key = schedule_key_m;
+        key.dates_m.push_back(start);
+        key.dates_m.push_back(end);
+        key.fudgeFirstFixing_m = fudge_first_fixing;
+
+        SchedulePool& pool = SchedulePool::instance();
+        // The unfudged schedule is pooled at validation.
+        if (!fudge_first_fixing)
+            pooled_trade_m.count(pool);
+        if (ScheduleInfo::Ptr pooled = pool.find(key))
+            return pooled;
+
+        return pool.insert(key, make_schedule(start, end, fudge_first_fixing));
+    }
+
+    // The fudged variant of the schedule frozen at refDate_m, made once.
+    ScheduleInfo::Ptr fudged_frozen_schedule() const
+    {
+        if (ScheduleInfo::Ptr fudged = fudged_schedule_m.get())
+            return fudged;
+
+        return fudged_schedule_m.set(pooled_schedule(refDate_m, true));
+    }
+
+    // The start and maturity the now date resolves to.  Both are calendar
+    // walks, so they are remembered per now date.
+    void resolve_dates(const Date& now_date, Date& start, Date& end) const
+    {
+        pair<Date, Date> dates;
+        if (!resolved_dates_m.find(now_date, dates))
+        {
+            dates.first = start_m.getDate(now_date);
+            dates.second = maturity_m.getDate(dates.first);
+            resolved_dates_m.insert(now_date, dates);
+        }
+        start = dates.first;
+        end = dates.second;
+    }
+
+    // Schedules depend only on the start and end the now date resolves to
+    // and the fudge flag, so repeat requests, including those from later now
+    // dates with the same spot date, are served from the schedule cache.
     virtual ScheduleInfo::Ptr calc_schedule(const Date& now_date,
                                             bool fudge_first_fixing) const
     {
-        Date start = start_m.getDate(now_date);
-        Date end = maturity_m.getDate(start);
+        Date start, end;
+        resolve_dates(now_date, start, end);
+
+        if (ScheduleInfo::Ptr cached = schedule_cache_m.find(start, end, fudge_first_fixing))
+            return cached;
+
+        return schedule_cache_m.insert(start,
+                                       end,
+                                       fudge_first_fixing,
+                                       make_schedule(start, end, fudge_first_fixing));
+    }
+
+    // Generates the schedule between the given dates.  Bypasses the cache.
+    virtual ScheduleInfo::Ptr make_schedule(const Date& start,
+                                            const Date& end,
+                                            bool fudge_first_fixing) const
+    {
+        return generate_schedule(start, end, fudge_first_fixing, fixed_leg_m, float_leg_m, NULL);
+    }
+
+    // Whether the schedule for a now date can be cut from a ladder master:
+    // only for floating tenor maturities without end-of-month rolling, and
+    // only where make_schedule is the one above.
+    virtual bool canLadder() const
+    {
+        return hasMaturityTenor() && !fixedEndOfMonth_m && !floatEndOfMonth_m;
+    }
+
+    virtual bool rateEndOfMonth() const
+    {
+        return rateEndOfMonth_m;
+    }
+
+    // Curve builds strip tenor ladders, so a stripping product takes its
+    // schedule from a ladder master when it can.  The schedule goes into the
+    // schedule cache, where calc_schedule finds it; later pricing on the
+    // same now date is served the same schedule, which ladder_schedule has
+    // checked against a standalone one.
+    virtual void prepareStripSchedule(const Date& nowDate,
+                                      bool fudgeFirstFixing) const
+    {
+        if (!canLadder())
+            return;
+
+        Date start, end;
+        resolve_dates(nowDate, start, end);
+        if (schedule_cache_m.contains(start, end, fudgeFirstFixing))
+            return;
+
+        if (ScheduleInfo::Ptr prefix = ladder_schedule(start, end, fudgeFirstFixing))
+            schedule_cache_m.insert(start, end, fudgeFirstFixing, prefix);
+    }
+
+    // Tenor ladders share a start and conventions, so the schedule is cut
+    // from a master running out to the ladder horizon.  Returns null when
+    // the master cannot reproduce the standalone schedule exactly.  The
+    // master is made with detached legs, so the bases of this trade are
+    // worked out from its own accrual dates and end date.  The first cut
+    // from each master is compared with make_schedule, and a master whose
+    // cut differs is not used again.
+    ScheduleInfo::Ptr ladder_schedule(const Date& start,
+                                      const Date& end,
+                                      bool fudge_first_fixing) const
+    {
+        SchedulePoolKey key = schedule_key_m;
+        key.dates_m.push_back(start);
+
+        ScheduleLadder& ladder = ScheduleLadder::instance();
+        ScheduleLadder::MasterPtr master = ladder.find(key, end);
+        if (!master)
+        {
+            Shared_ptr<ScheduleLadder::Master> built(new ScheduleLadder::Master);
+            built->end_m = Maturity(Tenor(ladder_horizon_s), maturityCal_m).getDate(start);
+            if (built->end_m < end)
+                built->end_m = end;
+            const LegCal fixedLeg = fixed_leg_m.detached(NULL);
+            const LegCal floatLeg = float_leg_m.detached(&fixedLeg);
+            built->schedule_m = generate_schedule(start, built->end_m, false, fixedLeg, floatLeg, built.get());
+            master = ladder.insert(key, built);
+        }
+
+        const int checked = master->checked_m.load(std::memory_order_acquire);
+        if (checked < 0 || !master->usable())
+            return ScheduleInfo::Ptr();
 
+        const size_t fixedCount = ScheduleLadder::Master::periodsTo(master->fixedBaDates_m, end);
+        const size_t floatCount = ScheduleLadder::Master::periodsTo(master->floatBaDates_m, end);
+        if (!fixedCount || !floatCount)
+            return ScheduleInfo::Ptr();
+
+        const vector<EventSchedule_I::IPeriod::CPtr>& fixedPeriods = master->schedule_m->fixed_m.dates_m;
+        const vector<EventSchedule_I::IPeriod::CPtr>& floatPeriods = master->schedule_m->float_m.dates_m;
+
+        const vector<Date> fixedBaDates(master->fixedBaDates_m.begin(),
+                                        master->fixedBaDates_m.begin() + fixedCount + 1);
+        const vector<Date> floatBaDates(master->floatBaDates_m.begin(),
+                                        master->floatBaDates_m.begin() + floatCount + 1);
+        bool eom = false;
+
+        Basis_I::CPtr fixedBasis = fixed_leg_m.getBasis(&fixedBaDates, &end, &eom);
+        Basis_I::CPtr floatBasis = float_leg_m.getBasis(&floatBaDates, &end, &eom);
+        const Basis_I::CPtr& rateBasis = InstrumentBase::getBasis(
+            rateBasisType_m, rateAccrualCal_m,
+            &floatBaDates, &rateFrequency_m, &end, &eom);
+
+        ScheduleInfo::Ptr prefix(new ScheduleInfo(vector<EventSchedule_I::IPeriod::CPtr>(fixedPeriods.begin(),
+                                                                                          fixedPeriods.begin() + fixedCount),
+                                                   fixedBasis,
+                                                   vector<EventSchedule_I::IPeriod::CPtr>(floatPeriods.begin(),
+                                                                                          floatPeriods.begin() + floatCount),
+                                                   floatBasis,
+                                                   rateBasis,
+                                                   useRateDates_m,
+                                                   rateAccrualCal_m,
+                                                   rateFrequency_m,
+                                                   rateFixingCal_m,
+                                                   rateSpotLag_m,
+                                                   rateEndOfMonth_m,
+                                                   fudge_first_fixing));
+
+        if (checked == 0)
+        {
+            ScheduleInfo::Ptr standalone = make_schedule(start, end, fudge_first_fixing);
+            const bool same = CompactSchedule(*prefix) == CompactSchedule(*standalone);
+            master->checked_m.store(same ? 1 : -1, std::memory_order_release);
+            if (!same)
+                return ScheduleInfo::Ptr();
+        }
+
+        ladder.addPrefix();
+        return prefix;
+    }
+
+    // Runs the schedule makers between the given dates for the given legs.
+    // When a master is given, it is also handed what is needed to truncate
+    // the result.
+    ScheduleInfo::Ptr generate_schedule(const Date& start,
+                                        const Date& end,
+                                        bool fudge_first_fixing,
+                                        const LegCal& fixedLeg,
+                                        const LegCal& floatLeg,
+                                        ScheduleLadder::Master* master) const
+    {
         ScheduleMaker fixed_maker(
             nominal_cal_m.get(),
-            start, end, fixed_leg_m.freq_m,
-            fixed_leg_m.front_stub_m, fixed_leg_m.long_stub_m,
+            start, end, fixedLeg.freq_m,
+            fixedLeg.front_stub_m, fixedLeg.long_stub_m,
             true, true, false,
-            fixed_leg_m.pay_cal_m.get(),
+            fixedLeg.pay_cal_m.get(),
             Tenor("0d"), false,
-            fixed_leg_m.pay_cal_m.get(), fixed_leg_m.pay_lag_m,
-            fixed_leg_m.acc_cal_m.get(),
+            fixedLeg.pay_cal_m.get(), fixedLeg.pay_lag_m,
+            fixedLeg.acc_cal_m.get(),
             fixedEndOfMonth_m);
 
         ScheduleMaker float_maker(
             nominal_cal_m.get(),
-            start, end, float_leg_m.freq_m,
-            float_leg_m.front_stub_m, float_leg_m.long_stub_m,
+            start, end, floatLeg.freq_m,
+            floatLeg.front_stub_m, floatLeg.long_stub_m,
             true, true, false,
             floatFixingCal_m.get(),
             floatFixingLag_m, false,
-            float_leg_m.pay_cal_m.get(), float_leg_m.pay_lag_m,
-            float_leg_m.acc_cal_m.get(),
+            floatLeg.pay_cal_m.get(), floatLeg.pay_lag_m,
+            floatLeg.acc_cal_m.get(),
             floatEndOfMonth_m);
 
         const vector<Date>* fixedBaDates = &fixed_maker.getBondAccrualDates();
         bool fixedEom = fixed_maker.isEOMDated();
-        Basis_I::CPtr fixedBasis = fixed_leg_m.getBasis(fixedBaDates, &end, &fixedEom);
+        Basis_I::CPtr fixedBasis = fixedLeg.getBasis(fixedBaDates, &end, &fixedEom);
 
         const vector<Date>* floatBaDates = &float_maker.getBondAccrualDates();
         bool floatEom = float_maker.isEOMDated();
-        Basis_I::CPtr floatBasis = float_leg_m.getBasis(floatBaDates, &end, &floatEom);
+        Basis_I::CPtr floatBasis = floatLeg.getBasis(floatBaDates, &end, &floatEom);
 
         const Basis_I::CPtr& rateBasis = InstrumentBase::getBasis(
             rateBasisType_m, rateAccrualCal_m,
             floatBaDates, &rateFrequency_m, &end, &floatEom);
 
+        if (master)
+        {
+            master->fixedBaDates_m = *fixedBaDates;
+            master->floatBaDates_m = *floatBaDates;
+            master->eom_m = fixedEom || floatEom || rateEndOfMonth_m;
+        }
+
         return ScheduleInfo::Ptr(new ScheduleInfo(fixed_maker.getDates(),
                                                   fixedBasis,
                                                   float_maker.getDates(),
@@ -2664,6 +4198,27 @@ public:
                 results.push_back(maturity_m.toString());
                 return true;
             }
+            CASE_ONE("SCHEDULECACHE")
+            {
+                results.push_back(static_cast<double>(scheduleCacheHits()));
+                results.push_back(static_cast<double>(scheduleCacheMisses()));
+                return true;
+            }
+            CASE_ONE("SCHEDULEPOOL")
+            {
+                const SchedulePool& pool = SchedulePool::instance();
+                results.push_back(static_cast<double>(pool.size()));
+                results.push_back(static_cast<double>(pool.trades()));
+                results.push_back(pool.dedupRatio());
+                return true;
+            }
+            CASE_ONE("SCHEDULELADDER")
+            {
+                const ScheduleLadder& ladder = ScheduleLadder::instance();
+                results.push_back(static_cast<double>(ladder.builds()));
+                results.push_back(static_cast<double>(ladder.prefixes()));
+                return true;
+            }
             DEFAULT_STATEMENT
                 warning.setFatal("\"" + iFace + "\" invalid interface for "
                     + String(InstrumentIRSwap::typeID_s) + " "
@@ -2686,10 +4241,21 @@ public:
             end = nowDate;
     }
 
+    size_t scheduleCacheHits() const
+    {
+        return schedule_cache_m.hits();
+    }
+
+    size_t scheduleCacheMisses() const
+    {
+        return schedule_cache_m.misses();
+    }
+
 protected:
     Date refDate_m;
     Start start_m;
     Maturity maturity_m;
+    Calendar_I::CPtr maturityCal_m;
 
     LegCal fixed_leg_m;
     LegCal float_leg_m;
@@ -2705,6 +4271,14 @@ protected:
     Tenor rateFrequency_m;
     Tenor rateSpotLag_m;
     BasisType rateBasisType_m;
+
+    // Everything but the start and end that goes into making the schedule.
+    SchedulePoolKey schedule_key_m;
+
+    mutable ScheduleCache schedule_cache_m;
+    mutable FudgedSchedule fudged_schedule_m;
+    mutable DateMemo<pair<Date, Date> > resolved_dates_m;
+    mutable PooledTrade pooled_trade_m;
 };
 
 struct FromEvents
@@ -2820,14 +4394,20 @@ protected:
             setMinorWarnings(floatEvents,
                              warning);
         const Date temp;
+        schedule_m = ScheduleInfo::Ptr();
         schedule_m = calc_schedule(temp, false);
 
         return true;
     }
 
+    // The periods come from the events, so once validate() has built the
+    // schedule it never changes.
     virtual ScheduleInfo::Ptr calc_schedule(const Date& now_date,
                                             bool fudge_first_fixing) const
     {
+        if (schedule_m)
+            return schedule_m;
+
         return ScheduleInfo::Ptr(new ScheduleInfo(fixedPeriods_m,
                                                   fixedBasis_m,
                                                   floatPeriods_m,
@@ -2897,9 +4477,10 @@ public:
         const ParseResult& result = getParameters();
         parseSingleCcyNotional(result);
 
+        schedule_m = ScheduleInfo::Ptr();
         if(refDate_m.isValid() || start_m.isDate()) 
         {
-            schedule_m = NewSwapTwoLegs::calc_schedule(refDate_m, false);
+            schedule_m = pooled_schedule(refDate_m, false);
         }
 
         return true;
@@ -2940,17 +4521,24 @@ protected:
             }
             else
             {
-                // Create a schedule with the same ref date, but respecting the new flags.
-                return NewSwapTwoLegs::calc_schedule(refDate_m, fudge_first_fixing);
+                // Same ref date, but respecting the new flags.  Made once and kept.
+                return fudged_frozen_schedule();
             }
         }
         else
         {
-            // All bets are off.  Cache is totally invalid.  Recompute everything.
+            // Floating: the schedule follows the now date, so it comes from
+            // the schedule cache keyed on the resolved start and end.
             return NewSwapTwoLegs::calc_schedule(now_date, fudge_first_fixing);
         }
     }
 
+    // A frozen schedule is not made per now date, so there is nothing to cut.
+    virtual bool canLadder() const
+    {
+        return !schedule_m && NewSwapTwoLegs::canLadder();
+    }
+
     virtual void view(ApplicationData& out) const {
         if (schedule_m) {  viewWithSchedule(out, schedule_m); }
     }
@@ -3043,6 +4631,18 @@ public:
         fixedBackStubType_m = EventsHelper_RollDate::getStubType(tmp);
         tmp = result.getString(tkFloatBackStubType, "NONE");
         floatBackStubType_m = EventsHelper_RollDate::getStubType(tmp);
+
+        ScheduleKeyWriter key;
+        key.add(schedule_key_m.conventions_m)
+           .add(static_cast<int>(fixedRollDateType_m))
+           .add(static_cast<int>(fixedFrontStubType_m))
+           .add(static_cast<int>(fixedBackStubType_m))
+           .add(static_cast<int>(floatRollDateType_m))
+           .add(static_cast<int>(floatFrontStubType_m))
+           .add(static_cast<int>(floatBackStubType_m));
+        schedule_key_m.conventions_m = key.str();
+        schedule_key_m.dates_m.push_back(fixedRollDate_m);
+        schedule_key_m.dates_m.push_back(floatRollDate_m);
     }
 
     virtual bool validate()
@@ -3055,9 +4655,10 @@ public:
 
         validateRollDateType();
 
+        schedule_m = ScheduleInfo::Ptr();
         if(refDate_m.isValid() || start_m.isDate())
         {
-            schedule_m = calc_schedule(refDate_m, false);
+            schedule_m = pooled_schedule(refDate_m, false);
         }
 
         return true;
@@ -3071,66 +4672,73 @@ public:
         // respect the fudge_first_fixing flag.
         //
         // If the precomputed schedule is not present, it is a floating instrument.
-        if (schedule_m && !fudge_first_fixing) 
+        if (schedule_m)
         {
-            return schedule_m;
-        }
-        else
-        {
-            Date refDate = schedule_m ? refDate_m : now_date;
-
-            Date start = start_m.getDate(refDate);
-            Date end = maturity_m.getDate(start);
-
-            ScheduleMaker fixed_maker(nominal_cal_m.get(),
-                                      start, end, fixedRollDate_m,
-                                      fixedRollDateType_m,
-                                      fixed_leg_m.freq_m,
-                                      fixedFrontStubType_m, fixedBackStubType_m,
-                                      true, true, false,
-                                      fixed_leg_m.pay_cal_m.get(),
-                                      Tenor("0d"), false,
-                                      fixed_leg_m.pay_cal_m.get(), fixed_leg_m.pay_lag_m,
-                                      fixed_leg_m.acc_cal_m.get(),
-                                      fixedEndOfMonth_m);
-
-            ScheduleMaker float_maker(nominal_cal_m.get(),
-                                      start, end, floatRollDate_m,
-                                      floatRollDateType_m,
-                                      float_leg_m.freq_m,
-                                      floatFrontStubType_m, floatBackStubType_m,
-                                      true, true, false,
-                                      floatFixingCal_m.get(),
-                                      floatFixingLag_m, false,
-                                      float_leg_m.pay_cal_m.get(), float_leg_m.pay_lag_m,
-                                      float_leg_m.acc_cal_m.get(),
-                                      floatEndOfMonth_m);
-
-            const vector<Date>* fixedBaDates = &fixed_maker.getBondAccrualDates();
-            bool fixedEom = fixed_maker.isEOMDated();
-            Basis_I::CPtr fixedBasis = fixed_leg_m.getBasis(fixedBaDates, &end, &fixedEom);
-
-            const vector<Date>* floatBaDates = &float_maker.getBondAccrualDates();
-            bool floatEom = float_maker.isEOMDated();
-            Basis_I::CPtr floatBasis = float_leg_m.getBasis(floatBaDates, &end, &floatEom);
-
-            const Basis_I::CPtr& rateBasis = InstrumentBase::getBasis(
-                rateBasisType_m, rateAccrualCal_m,
-                floatBaDates, &rateFrequency_m, &end, &floatEom);
-
-            return ScheduleInfo::Ptr(new ScheduleInfo(fixed_maker.getDates(),
-                                                      fixedBasis,
-                                                      float_maker.getDates(),
-                                                      floatBasis,
-                                                      rateBasis,
-                                                      useRateDates_m,
-                                                      rateAccrualCal_m,
-                                                      rateFrequency_m,
-                                                      rateFixingCal_m,
-                                                      rateSpotLag_m,
-                                                      rateEndOfMonth_m,
-                                                      fudge_first_fixing));
+            return fudge_first_fixing ? fudged_frozen_schedule() : schedule_m;
         }
+
+        return NewSwapTwoLegs::calc_schedule(now_date, fudge_first_fixing);
+    }
+
+    // Roll dates place the periods, so the schedule is not a prefix of a
+    // ladder master.
+    virtual bool canLadder() const
+    {
+        return false;
+    }
+
+    virtual ScheduleInfo::Ptr make_schedule(const Date& start,
+                                            const Date& end,
+                                            bool fudge_first_fixing) const
+    {
+        ScheduleMaker fixed_maker(nominal_cal_m.get(),
+                                  start, end, fixedRollDate_m,
+                                  fixedRollDateType_m,
+                                  fixed_leg_m.freq_m,
+                                  fixedFrontStubType_m, fixedBackStubType_m,
+                                  true, true, false,
+                                  fixed_leg_m.pay_cal_m.get(),
+                                  Tenor("0d"), false,
+                                  fixed_leg_m.pay_cal_m.get(), fixed_leg_m.pay_lag_m,
+                                  fixed_leg_m.acc_cal_m.get(),
+                                  fixedEndOfMonth_m);
+
+        ScheduleMaker float_maker(nominal_cal_m.get(),
+                                  start, end, floatRollDate_m,
+                                  floatRollDateType_m,
+                                  float_leg_m.freq_m,
+                                  floatFrontStubType_m, floatBackStubType_m,
+                                  true, true, false,
+                                  floatFixingCal_m.get(),
+                                  floatFixingLag_m, false,
+                                  float_leg_m.pay_cal_m.get(), float_leg_m.pay_lag_m,
+                                  float_leg_m.acc_cal_m.get(),
+                                  floatEndOfMonth_m);
+
+        const vector<Date>* fixedBaDates = &fixed_maker.getBondAccrualDates();
+        bool fixedEom = fixed_maker.isEOMDated();
+        Basis_I::CPtr fixedBasis = fixed_leg_m.getBasis(fixedBaDates, &end, &fixedEom);
+
+        const vector<Date>* floatBaDates = &float_maker.getBondAccrualDates();
+        bool floatEom = float_maker.isEOMDated();
+        Basis_I::CPtr floatBasis = float_leg_m.getBasis(floatBaDates, &end, &floatEom);
+
+        const Basis_I::CPtr& rateBasis = InstrumentBase::getBasis(
+            rateBasisType_m, rateAccrualCal_m,
+            floatBaDates, &rateFrequency_m, &end, &floatEom);
+
+        return ScheduleInfo::Ptr(new ScheduleInfo(fixed_maker.getDates(),
+                                                  fixedBasis,
+                                                  float_maker.getDates(),
+                                                  floatBasis,
+                                                  rateBasis,
+                                                  useRateDates_m,
+                                                  rateAccrualCal_m,
+                                                  rateFrequency_m,
+                                                  rateFixingCal_m,
+                                                  rateSpotLag_m,
+                                                  rateEndOfMonth_m,
+                                                  fudge_first_fixing));
     }
 
     virtual void view(ApplicationData& out) const {
@@ -3248,9 +4856,10 @@ public:
         parseCurrencies(result);
         parseCrossCcyNotionals(result);
 
+        schedule_m = ScheduleInfo::Ptr();
         if(refDate_m.isValid() || start_m.isDate())
         {
-            schedule_m = NewSwapTwoLegs::calc_schedule(refDate_m, false);
+            schedule_m = pooled_schedule(refDate_m, false);
         }
 
         return true;
@@ -3298,7 +4907,7 @@ protected:
             }
             else
             {
-                return NewSwapTwoLegs::calc_schedule(refDate_m, fudge_first_fixing);
+                return fudged_frozen_schedule();
             }
             
         }
@@ -3309,6 +4918,12 @@ protected:
          
     }
 
+    // A frozen schedule is not made per now date, so there is nothing to cut.
+    virtual bool canLadder() const
+    {
+        return !schedule_m && NewSwapTwoLegs::canLadder();
+    }
+
     virtual void view(ApplicationData& out) const {
         if (schedule_m) {  viewWithSchedule(out, schedule_m); }
     }
@@ -3888,32 +5503,27 @@ protected:
         floatStubIndexCurve_m = result.queryPtr(tkFloatStubIndexCurve);
 
         const Date temp;
+        schedule_m = ScheduleInfo::Ptr();
         schedule_m = calc_schedule(temp, false);
 
         return true;
     }
 
+    struct TimeDependentPayoffTerms
+    {
+        bool initialNotionalExchange_m;
+        bool finalNotionalExchange_m;
+        Swap::SwapPayoff::Shape shape_m;
+    };
+
+    template <bool UseCashflows, bool CrossCurrency, bool Stubs>
     class TimeDependentSwapPayoff : public Swap::SwapPayoff
     {
     public:
-        TimeDependentSwapPayoff(const CurrencyType fixedCurrType,
-                                const CurrencyType floatCurrType,
-                                bool useCashflows,
-                                bool initialNotionalExchange,
-                                bool finalNotionalExchange,
-                                bool doFrontStubInterpolation,
-                                bool doBackStubInterpolation,
-                                const pair<double,double>& frontStubRateWeights,
-                                const pair<double,double>& backStubRateWeights) :
-        SwapPayoff(fixedCurrType,
-                   floatCurrType,
-                   doFrontStubInterpolation,
-                   doBackStubInterpolation,
-                   frontStubRateWeights,
-                   backStubRateWeights),
-        useCashflows_m(useCashflows),
-        initialNotionalExchange_m(initialNotionalExchange),
-        finalNotionalExchange_m(finalNotionalExchange)
+        explicit TimeDependentSwapPayoff(const TimeDependentPayoffTerms& terms) :
+        SwapPayoff(terms.shape_m),
+        initialNotionalExchange_m(terms.initialNotionalExchange_m),
+        finalNotionalExchange_m(terms.finalNotionalExchange_m)
         {}
 
         virtual const PricingDirectionType getPricingDirection() const
@@ -3926,56 +5536,69 @@ protected:
             Underlying fixed_leg = get(coupon_leg_str);
             Underlying float_leg = get(fund_leg_str);
 
-            if(isActive(coupon_date_str))
-            {
-                if(!useCashflows_m)
-                {
-                    const Underlying fixedNotional = get(fixed_notional);
-                    doFixedLeg(fixedNotional,
-                               fixed_leg);
-                }
-                else
-                {
-                    doFixedLeg(fixed_leg);
-                }
-            }
-
-            if(isActive(fund_date_str))
-            {
-                const Underlying floatNotional = get(float_notional);
-                doFloatLeg(floatNotional,
-                           float_leg);
-            }
-
-            if(isCrossCurrency_m)
+            // The exchange needs both notionals on every call, so they are
+            // fetched once for the coupons as well.
+            if(CrossCurrency)
             {
                 const Underlying fixedNotional = get(fixed_notional);
                 const Underlying floatNotional = get(float_notional);
+                doCoupons(fixedNotional, floatNotional, fixed_leg, float_leg);
                 doNotionalExchange(fixedNotional, floatNotional,
                                    initialNotionalExchange_m, finalNotionalExchange_m,
                                    fixed_leg, float_leg);
             }
+            else
+                doCoupons(fixed_leg, float_leg);
 
             Underlying swap = get(swap_str);
-            getSwap(fixed_leg, float_leg,
-                    swap);
+            getSwap<CrossCurrency>(fixed_leg, float_leg,
+                                   swap);
         }
 
         virtual Cloneable_I* clone() const
         {
-            return new TimeDependentSwapPayoff(fixedCurrType_m,
-                                               floatCurrType_m,
-                                               useCashflows_m,
-                                               initialNotionalExchange_m,
-                                               finalNotionalExchange_m,
-                                               doFrontStubInterpolation_m,
-                                               doBackStubInterpolation_m,
-                                               frontStubRateWeights_m,
-                                               backStubRateWeights_m);
+            TimeDependentPayoffTerms terms;
+            terms.initialNotionalExchange_m = initialNotionalExchange_m;
+            terms.finalNotionalExchange_m = finalNotionalExchange_m;
+            terms.shape_m = shape();
+
+            return new TimeDependentSwapPayoff(terms);
         }
 
     private:
-        bool useCashflows_m;
+        void doCoupons(const Underlying& fixedNotional,
+                       const Underlying& floatNotional,
+                       Underlying& fixed_leg,
+                       Underlying& float_leg)
+        {
+            if(isActive(coupon_date_str))
+            {
+                if(UseCashflows)
+                    doFixedLeg<CrossCurrency>(fixed_leg);
+                else
+                    doFixedLeg<CrossCurrency>(fixedNotional, fixed_leg);
+            }
+
+            if(isActive(fund_date_str))
+                doFloatLeg<Stubs>(floatNotional, float_leg);
+        }
+
+        // As above, fetching each notional only for a leg that pays.
+        void doCoupons(Underlying& fixed_leg,
+                       Underlying& float_leg)
+        {
+            if(isActive(coupon_date_str))
+            {
+                if(UseCashflows)
+                    doFixedLeg<CrossCurrency>(fixed_leg);
+                else
+                    doFixedLeg<CrossCurrency>(get(fixed_notional), fixed_leg);
+            }
+
+            if(isActive(fund_date_str))
+                doFloatLeg<Stubs>(get(float_notional), float_leg);
+        }
+
         bool initialNotionalExchange_m;
         bool finalNotionalExchange_m;
     };
@@ -4014,22 +5637,31 @@ protected:
                                 const pair<double,double>& frontStubRateWeights,
                                 const pair<double,double>& backStubRateWeights)
     {
-        TimeDependentSwapPayoff payoff(fixedCurrencyType,
-                                       floatCurrencyType,
-                                       fixedRate_m.size() ? false : true,
-                                       initialNotionalExchange_m,
-                                       finalNotionalExchange_m,
-                                       doFrontStubInterpolation,
-                                       doBackStubInterpolation,
-                                       frontStubRateWeights,
-                                       backStubRateWeights);
-
-        kernel->registerPayoff(payoff);
-    }
-
+        TimeDependentPayoffTerms terms;
+        terms.initialNotionalExchange_m = initialNotionalExchange_m;
+        terms.finalNotionalExchange_m = finalNotionalExchange_m;
+        terms.shape_m.fixedCurrType_m = fixedCurrencyType;
+        terms.shape_m.floatCurrType_m = floatCurrencyType;
+        terms.shape_m.doFrontStubInterpolation_m = doFrontStubInterpolation;
+        terms.shape_m.doBackStubInterpolation_m = doBackStubInterpolation;
+        terms.shape_m.frontStubRateWeights_m = frontStubRateWeights;
+        terms.shape_m.backStubRateWeights_m = backStubRateWeights;
+        terms.shape_m.logPayments_m = logPayments_m;
+
+        registerPayoffVariant<TimeDependentSwapPayoff>(kernel,
+                                                       fixedRate_m.size() ? false : true,
+                                                       terms.shape_m.isCrossCurrency(),
+                                                       terms.shape_m.hasStubs(),
+                                                       terms);
+    }
+
+    // As for NewSwapFromEvents, the schedule is fixed by the events.
     virtual ScheduleInfo::Ptr calc_schedule(const Date& nowDate,
                                             bool fudge_first_fixing) const
     {
+        if (schedule_m)
+            return schedule_m;
+
         return ScheduleInfo::Ptr(new ScheduleInfo(fixedPeriods_m,
                                                   fixedBasis_m,
                                                   floatPeriods_m,
@@ -4599,7 +6231,7 @@ protected:
                            fixedCurrencyType,
                            floatCurrencyType);
 
-        kernel->registerDCF(coupon_dcf_str, coupon_date_str, basisType);
+        registerAccrualFractions(kernel, registrationSchedule(model), true, coupon_dcf_str, coupon_date_str, basisType);
     }
 };
 
@@ -4707,6 +6339,7 @@ public:
         float_leg_m.init(result, float_leg_check_s, &fixed_leg_m);
 
         fixing_info_m.init(result);
+        libor_dates_m.clear();
 
         return true;
     }
@@ -4727,14 +6360,25 @@ public:
                               fixing_info_m.fixing_cal_m.get());
     }
 
+    virtual bool usesRateDates() const
+    {
+        return !float_leg_m.freq_m.isZeroTenor() &&
+            float_leg_m.acc_cal_m && fixing_info_m.fixing_cal_m;
+    }
+
     virtual Date getInstrumentMaturity(
         const Date& nowDate,
         const Date& fixDate) const
     {
         Date result = OldSwap::getInstrumentMaturity(nowDate, fixDate);
-        Date liborDate = fixDate;
-        fixing_info_m.fixing_cal_m->addTenor(liborDate, fixing_info_m.fixing_lag_m);
-        float_leg_m.acc_cal_m->addTenor(liborDate, float_leg_m.freq_m);
+        Date liborDate;
+        if (!libor_dates_m.find(fixDate, liborDate))
+        {
+            liborDate = fixDate;
+            fixing_info_m.fixing_cal_m->addTenor(liborDate, fixing_info_m.fixing_lag_m);
+            float_leg_m.acc_cal_m->addTenor(liborDate, float_leg_m.freq_m);
+            libor_dates_m.insert(fixDate, liborDate);
+        }
         if (result < liborDate)
             result = liborDate;
 
@@ -4794,6 +6438,9 @@ protected:
     LegCal fixed_leg_m;
     LegCal float_leg_m;
     FixingInfo fixing_info_m;
+
+    // End of the rate period fixing on each date.
+    mutable DateMemo<Date> libor_dates_m;
 };
 
 class DateOneLegSwap : public ExplicitOneLegSwap
@@ -4819,19 +6466,27 @@ public:
                                                   date_range_m.end_date_m,
                                                   single_leg_m.pay_cal_m,
                                                   Tenor("0D"), false);
+        fudged_schedule_m.clear();
         return true;
     }
 
 protected:
 
+    // Both variants depend only on the date range, so each is made once.
     virtual ScheduleInfo::Ptr calc_schedule(
         const Date& now_date,
         bool fudge_first_fixing) const 
     {
-        return calc_one_leg_schedule(date_range_m.start_date_m,
-            date_range_m.end_date_m,
-            single_leg_m.pay_cal_m,
-            Tenor("0D"), fudge_first_fixing);
+        if (!fudge_first_fixing)
+            return schedule_m;
+
+        if (ScheduleInfo::Ptr fudged = fudged_schedule_m.get())
+            return fudged;
+
+        return fudged_schedule_m.set(calc_one_leg_schedule(date_range_m.start_date_m,
+                                                           date_range_m.end_date_m,
+                                                           single_leg_m.pay_cal_m,
+                                                           Tenor("0D"), true));
     }
 
     virtual void view(ApplicationData& out) const {
@@ -4839,6 +6494,7 @@ protected:
     }
 
 	ScheduleInfo::Ptr schedule_m;
+    mutable FudgedSchedule fudged_schedule_m;
 
     DateRange date_range_m;
 };
@@ -4870,24 +6526,40 @@ public:
             refDate_m = result.getDate(tkEventsRefDate);
         }
 
+        schedule_cache_m.clear();
+        boundaries_m.clear();
+
         return true;
     }
 
     virtual ScheduleInfo::Ptr calc_schedule(const Date& now_date,
                                             bool fudge_first_fixing) const
     {
-        Date start, end;
-        fixing_info_m.getBoundaries(start,
-                                    end,
-                                    refDate_m.getOrElse(now_date),
-                                    NULL,
-                                    tenor_range_m,
-                                    nominal_cal_m.get());
+        const Date refDate = refDate_m.getOrElse(now_date);
+        pair<Date, Date> boundaries;
+        if (!boundaries_m.find(refDate, boundaries))
+        {
+            fixing_info_m.getBoundaries(boundaries.first,
+                                        boundaries.second,
+                                        refDate,
+                                        NULL,
+                                        tenor_range_m,
+                                        nominal_cal_m.get());
+            boundaries_m.insert(refDate, boundaries);
+        }
+        const Date& start = boundaries.first;
+        const Date& end = boundaries.second;
 
-        return calc_one_leg_schedule(start, end,
-                                     fixing_info_m.fixing_cal_m,
-                                     fixing_info_m.fixing_lag_m,
-                                     fudge_first_fixing);
+        if (ScheduleInfo::Ptr cached = schedule_cache_m.find(start, end, fudge_first_fixing))
+            return cached;
+
+        return schedule_cache_m.insert(start,
+                                       end,
+                                       fudge_first_fixing,
+                                       calc_one_leg_schedule(start, end,
+                                                             fixing_info_m.fixing_cal_m,
+                                                             fixing_info_m.fixing_lag_m,
+                                                             fudge_first_fixing));
     }
 
     bool hasMaturityTenor() const
@@ -4910,6 +6582,9 @@ protected:
     FixingInfo fixing_info_m;
 
     Option<Date> refDate_m;
+
+    mutable ScheduleCache schedule_cache_m;
+    mutable DateMemo<pair<Date, Date> > boundaries_m;
 };
 
 class DateTwoLegSwap : public ExplicitTwoLegSwap
@@ -4982,21 +6657,35 @@ public:
             refDate_m = result.getDate(tkEventsRefDate);
         }
 
+        schedule_cache_m.clear();
+        boundaries_m.clear();
+
         return true;
     }
 
     virtual ScheduleInfo::Ptr calc_schedule(const Date& now_date,
                                             bool fudge_first_fixing) const
     {
-        Date start, end;
-        fixing_info_m.getBoundaries(start,
-                                    end,
-                                    refDate_m.getOrElse(now_date),
-                                    float_leg_m.acc_cal_m.get(),
-                                    tenor_range_m,
-                                    nominal_cal_m.get());
+        const Date refDate = refDate_m.getOrElse(now_date);
+        pair<Date, Date> boundaries;
+        if (!boundaries_m.find(refDate, boundaries))
+        {
+            fixing_info_m.getBoundaries(boundaries.first,
+                                        boundaries.second,
+                                        refDate,
+                                        float_leg_m.acc_cal_m.get(),
+                                        tenor_range_m,
+                                        nominal_cal_m.get());
+            boundaries_m.insert(refDate, boundaries);
+        }
+        const Date& start = boundaries.first;
+        const Date& end = boundaries.second;
 
-        return calc_two_leg_schedule(start, end);
+        // The two-leg schedule does not depend on the fudge flag.
+        if (ScheduleInfo::Ptr cached = schedule_cache_m.find(start, end, false))
+            return cached;
+
+        return schedule_cache_m.insert(start, end, false, calc_two_leg_schedule(start, end));
     }
 
     bool hasMaturityTenor() const
@@ -5020,6 +6709,9 @@ protected:
     TenorRange tenor_range_m;
 
     Option<Date> refDate_m;
+
+    mutable ScheduleCache schedule_cache_m;
+    mutable DateMemo<pair<Date, Date> > boundaries_m;
 };
 
 class ScheduleOneLegSwap : public OldSwap